@@ -0,0 +1,38 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../Project_Settings/Startup_Code/startup.c \
+../Project_Settings/Startup_Code/system_S32K144.c 
+
+S_UPPER_SRCS += \
+../Project_Settings/Startup_Code/startup_S32K144.S 
+
+OBJS += \
+./Project_Settings/Startup_Code/startup.o \
+./Project_Settings/Startup_Code/startup_S32K144.o \
+./Project_Settings/Startup_Code/system_S32K144.o 
+
+C_DEPS += \
+./Project_Settings/Startup_Code/startup.d \
+./Project_Settings/Startup_Code/system_S32K144.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+Project_Settings/Startup_Code/%.o: ../Project_Settings/Startup_Code/%.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: Standard S32DS C Compiler'
+	arm-none-eabi-gcc "@Project_Settings/Startup_Code/startup.args" -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Project_Settings/Startup_Code/%.o: ../Project_Settings/Startup_Code/%.S
+	@echo 'Building file: $<'
+	@echo 'Invoking: Standard S32DS Assembler'
+	arm-none-eabi-gcc "@Project_Settings/Startup_Code/startup_S32K144.args" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
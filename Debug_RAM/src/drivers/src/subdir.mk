@@ -6,6 +6,7 @@
 C_SRCS += \
 ../src/drivers/src/DRV_S32K144_ADC.c \
 ../src/drivers/src/DRV_S32K144_FLEXCAN.c \
+../src/drivers/src/DRV_S32K144_FTFC.c \
 ../src/drivers/src/DRV_S32K144_GPIO.c \
 ../src/drivers/src/DRV_S32K144_LPIT.c \
 ../src/drivers/src/DRV_S32K144_MCU.c \
@@ -15,6 +16,7 @@ C_SRCS += \
 OBJS += \
 ./src/drivers/src/DRV_S32K144_ADC.o \
 ./src/drivers/src/DRV_S32K144_FLEXCAN.o \
+./src/drivers/src/DRV_S32K144_FTFC.o \
 ./src/drivers/src/DRV_S32K144_GPIO.o \
 ./src/drivers/src/DRV_S32K144_LPIT.o \
 ./src/drivers/src/DRV_S32K144_MCU.o \
@@ -24,6 +26,7 @@ OBJS += \
 C_DEPS += \
 ./src/drivers/src/DRV_S32K144_ADC.d \
 ./src/drivers/src/DRV_S32K144_FLEXCAN.d \
+./src/drivers/src/DRV_S32K144_FTFC.d \
 ./src/drivers/src/DRV_S32K144_GPIO.d \
 ./src/drivers/src/DRV_S32K144_LPIT.d \
 ./src/drivers/src/DRV_S32K144_MCU.d \
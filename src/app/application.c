@@ -13,6 +13,9 @@
 #include "MID_Timer_Interface.h"
 #include "MID_CAN_Interface.h"
 #include "MID_GPIO_Interface.h"
+#include "MID_TimeSync_Interface.h"
+#include "MID_IsoTp_Interface.h"
+#include "MID_Boot_Interface.h"
 
 /*******************************************************************************
  * Definition
@@ -24,18 +27,99 @@
 /* Threshold for triggering a CAN message when sensor value changes */
 #define CHANGE_THRESHOLD    (5U)
 
+/*
+ * Low-latency mode: while streaming (STATE_ACTIVE), the ADC completion ISR
+ * converts the result, applies the change rule and queues the frame itself
+ * instead of deferring to the main loop. The path has no waits, but it is not
+ * constant: besides the conversion it runs the latency bookkeeping, the global
+ * time conversion and MID_CAN_SendCANFrame, whose token bucket refill and
+ * scans of the Tx queue (up to CAN_TX_QUEUE_DEPTH entries) and of the Tx
+ * mailbox pool depend on what is pending. No cycle count is claimed; measure it
+ * on target, e.g. with DWT CYCCNT around App_Sensor_Notification. The deferred
+ * path instead depends on where the main loop is, up to one full loop
+ * iteration, including a flash command of a firmware update.
+ * Selects the default at build time, it can be switched at runtime with
+ * RX_MSG_LOW_LATENCY_ON_DATA / RX_MSG_LOW_LATENCY_OFF_DATA.
+ */
+#ifndef APP_LOW_LATENCY_MODE
+#define APP_LOW_LATENCY_MODE    (0U)
+#endif
+
+/*
+ * Batching mode: in the deferred path every sample is appended to a batch
+ * instead of going through the change rule, so one classic frame carries up
+ * to APP_BATCH_SIZE samples. TX_ROTATION_BATCH_MSG payload:
+ *   byte 0      sequence number of the first sample (sample count mod 256)
+ *   byte 1      number of samples, 1..APP_BATCH_SIZE
+ *   bytes 2..3  first sample, big-endian
+ *   bytes 4..6  signed 8-bit delta of samples 2..4 to the previous sample
+ *   byte 7      0
+ * A batch is sent when it is full, when its first sample is
+ * APP_BATCH_MAX_LATENCY_MS old, or at once when a sample moves by more than
+ * APP_BATCH_URGENT_DELTA. A step that does not fit a delta starts a new batch.
+ * Low-latency mode bypasses batching.
+ * The latency bound follows the sampling period: it leaves room for the
+ * APP_BATCH_SIZE - 1 samples after the first, plus half a period of jitter,
+ * so a steady signal fills every batch and the timer only flushes a batch
+ * cut short by a stop or by a lost trigger.
+ */
+#ifndef APP_BATCH_MODE
+#define APP_BATCH_MODE              (0U)
+#endif
+
+#define APP_BATCH_SIZE              (4U)
+#define APP_BATCH_MAX_LATENCY_MS    (((APP_BATCH_SIZE - 1U) * TIMER_SAMPLE_PERIOD_MS) + (TIMER_SAMPLE_PERIOD_MS / 2U))
+#define APP_BATCH_URGENT_DELTA      (64)
+
+/*
+ * Requests on ISO-TP channel APP_ISOTP_CHANNEL, byte 0 is the service. The
+ * response repeats it with APP_SERVICE_RESPONSE added.
+ * APP_SERVICE_STATS_DUMP response, each counter a big-endian uint32:
+ *   sensor     overruns, skipped triggers, late conversions, worst latency us
+ *   CAN Rx     received, FIFO warnings, FIFO overflows
+ *   CAN error  warnings, error passive, bus-offs, recoveries, requeued,
+ *              longest recovery us
+ */
+#define APP_ISOTP_CHANNEL           (0U)
+#define APP_SERVICE_STATS_DUMP      (0x01U)
+#define APP_SERVICE_RESPONSE        (0x40U)
+#define APP_STATS_DUMP_WORDS        (13U)
+
+/* Saturate a counter to the 16-bit field of the statistics frame */
+#define SAT_U16(x)    (((x) > 0xFFFFU) ? 0xFFFFU : (x))
+
 typedef enum
 {
     STATE_ACTIVE,
     STATE_STOP
 } State_Type;
 
+/* Samples waiting to be sent in one batch frame */
+typedef struct
+{
+    uint8_t  Count;
+    uint8_t  Sequence;                      /* Sequence number of the first sample */
+    uint16_t First;
+    int8_t   Delta[APP_BATCH_SIZE - 1U];
+} Batch_Typedef;
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
-static void App_ReceiveMessageNotification(void);
+static void App_ReceiveMessageNotification(const Data_Typedef *Message);
 static void App_TriggerSensor_Notification(void);
 static void App_Sensor_Notification(void);
+static void App_SendSensorStats(void);
+static void App_SendBusLoad(void);
+static void App_ProcessSample(uint16_t Value);
+static void App_BatchSample(uint16_t Value);
+static void App_BatchFlush(void);
+static void App_ValueRequest(uint32_t Mode);
+static void App_SendValueReply(uint16_t Value, uint32_t SampleTime);
+static void App_TxConfirmNotification(uint8_t Tx_Msg, uint32_t TimeStamp);
+static void App_IsoTpReceiveNotification(uint8_t Channel, const uint8_t *Data, uint16_t Length);
+static void App_IsoTpTxDoneNotification(uint8_t Channel, uint8_t Result);
+static void App_SendStatsDump(void);
 
 /*******************************************************************************
  * Variables
@@ -45,15 +129,37 @@ uint16_t Cur_Sensor_Value = 0U;
 uint16_t Pre_Sensor_Value = 0U;
 uint16_t Delta            = 0U;
 
-/* Structure to save received CAN data */
-static Data_Typedef Data_Receive;
-
 /* The current state of the application. */
 static volatile State_Type g_current_state = STATE_ACTIVE;
 
 /* Flag indicating whether this is the first entry into the active state */
 static bool g_isActiveEntry = true;
 
+/* Flag indicating whether samples are processed in the ADC ISR */
+static volatile bool g_isLowLatencyMode = (APP_LOW_LATENCY_MODE != 0U);
+
+/* Flag indicating whether deferred samples are sent in batches */
+static volatile bool g_isBatchMode = (APP_BATCH_MODE != 0U);
+
+/* Batch being filled, only accessed from the main loop */
+static Batch_Typedef g_batch;
+
+/* Last sample appended to a batch, reference of the next delta */
+static uint16_t g_batchLastValue = 0U;
+
+/* Sequence number of the next sample */
+static uint8_t g_batchSequence = 0U;
+
+/* Flag indicating that a get-value request waits for the next conversion */
+static volatile bool g_isValueRequested = false;
+
+/* Statistics dump being sent, owned by the ISO-TP channel until its Tx done */
+static uint8_t g_dumpBuffer[1U + (4U * APP_STATS_DUMP_WORDS)];
+static volatile bool g_isDumpPending = false;
+
+/* Flushes a batch after APP_BATCH_MAX_LATENCY_MS, runs in the main loop */
+static uint8_t g_batchTimerId = SW_TIMER_INVALID_ID;
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -66,23 +172,40 @@ static bool g_isActiveEntry = true;
   */
 int main(void)
 {
+    uint16_t Value = 0U;
+
+    /* A verified updated image takes over before anything is initialized */
+    MID_Boot_StartImage();
+
     /* Initialize system peripherals */
     MID_Clock_Init();
+    MID_Timer_Init();
     MID_CAN_Init();
+    MID_IsoTp_Init();
+    MID_Boot_Init();
     MID_Sensor_Init();
-    MID_Timer_Init();
     MID_Led_Init();
 
     /* Register notification callbacks */
     MID_Timer_RegisterNotificationCallback(&App_TriggerSensor_Notification);
     MID_ADC_RegisterNotificationCallback(&App_Sensor_Notification);
     MID_CAN_RegisterRxNotificationCallback(&App_ReceiveMessageNotification);
+    MID_CAN_RegisterTxConfirmCallback(&App_TxConfirmNotification);
+    MID_IsoTp_RegisterRxCallback(&App_IsoTpReceiveNotification);
+    MID_IsoTp_RegisterTxDoneCallback(&App_IsoTpTxDoneNotification);
+    g_batchTimerId = MID_SwTimer_Create(&App_BatchFlush, SW_TIMER_CONTEXT_THREAD);
 
     /* Enable notifications and start periodic timer */
     MID_EnableNotification();
 
     while(1)
     {
+        /* Thread-context timer callbacks, e.g. the batch latency flush */
+        MID_SwTimer_Process();
+
+        /* Firmware update requests, one flash command per iteration */
+        MID_Boot_Process();
+
         switch (g_current_state)
         {
             case STATE_ACTIVE:
@@ -93,18 +216,17 @@ int main(void)
                     g_isActiveEntry = false;
                 }
 
-                if(MID_Get_DataSensorState() == READY_TO_READ)
-                {
-                    Cur_Sensor_Value = MID_Read_RotationValue();
-                    MID_Set_DataSensorState(IDLE);
-                }
-
-                Delta = ABS(Cur_Sensor_Value, Pre_Sensor_Value);
-
-                if(Delta > CHANGE_THRESHOLD)
+                /* Left READY_TO_READ by the ADC ISR only outside low-latency mode */
+                if(MID_Sensor_TakeSample(&Value) == true)
                 {
-                    Pre_Sensor_Value = Cur_Sensor_Value;
-                    MID_CAN_SendCANMessage(TX_ROTATION_DATA_MB, Cur_Sensor_Value);
+                    if (g_isBatchMode == true)
+                    {
+                        App_BatchSample(Value);
+                    }
+                    else
+                    {
+                        App_ProcessSample(Value);
+                    }
                 }
                 break;
 
@@ -124,71 +246,432 @@ int main(void)
 
 /**
   * @brief Callback for handling received CAN messages.
-  *        Processes messages from specific mailboxes and sends acknowledgment.
+  *        Called once per frame accepted by the Rx FIFO and sends acknowledgment.
+  * @param  Message: received ID and payload word 0
+  * @retval None
+  */
+static void App_ReceiveMessageNotification(const Data_Typedef *Message)
+{
+    switch (Message->ID)
+    {
+        case RX_MSG_CONNECTION_ID:
+            MID_CAN_SendCANMessage(TX_CONFIRM_CONNECTION_MSG, TX_MSG_CONFIRM_CONNECTION_DATA);
+            break;
+
+        case RX_MSG_STOPOPR_ID:
+            if (Message->Data == RX_MSG_STOP_OPR_DATA)
+            {
+                g_current_state = STATE_STOP;
+            }
+            else if (Message->Data == RX_MSG_RESUME_OPR_DATA)
+            {
+                g_current_state = STATE_ACTIVE;
+            }
+            else if (Message->Data == RX_MSG_LOW_LATENCY_ON_DATA)
+            {
+                g_isLowLatencyMode = true;
+            }
+            else if (Message->Data == RX_MSG_LOW_LATENCY_OFF_DATA)
+            {
+                g_isLowLatencyMode = false;
+            }
+            else if (Message->Data == RX_MSG_BATCH_ON_DATA)
+            {
+                g_isBatchMode = true;
+            }
+            else if (Message->Data == RX_MSG_BATCH_OFF_DATA)
+            {
+                /* A pending batch is still sent by its latency timer */
+                g_isBatchMode = false;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+            break;
+
+        case RX_PING_MSG_ID:
+            MID_CAN_SendCANMessage(TX_CONFIRM_PING_MSG, TX_MSG_CONFIRM_CONNECTION_DATA);
+            break;
+
+        case RX_MSG_GET_STATS_ID:
+            App_SendSensorStats();
+            break;
+
+        case RX_MSG_GET_BUS_LOAD_ID:
+            App_SendBusLoad();
+            break;
+
+        case RX_MSG_GET_VALUE_ID:
+            App_ValueRequest(Message->Data);
+            break;
+
+        case RX_MSG_TIME_SYNC_ID:
+            MID_TimeSync_OnSync((uint8_t)(Message->Data >> 24U), Message->TimeStamp);
+            break;
+
+        case RX_MSG_TIME_FUP_ID:
+            MID_TimeSync_OnFollowUp(Message->Data, Message->TimeStamp);
+            break;
+
+        case RX_MSG_ISOTP_CH0_ID:
+        case RX_MSG_ISOTP_CH1_ID:
+            MID_IsoTp_OnFrame(Message);
+            break;
+
+        case RX_MSG_CONFIRM_DATA_ID:
+        default:
+            /* Do nothing */
+            break;
+    }
+}
+
+/**
+  * @brief Sends the acquisition pipeline statistics.
+  *        Payload: overruns, skipped triggers, late conversions and
+  *        worst-case latency in us, each as a saturated big-endian uint16.
+  * @param  None
+  * @retval None
+  */
+static void App_SendSensorStats(void)
+{
+    SensorStats_Typedef Stats;
+
+    MID_Sensor_GetStats(&Stats);
+
+    MID_CAN_SendCANFrame(TX_SENSOR_STATS_MSG,
+                         ((uint32_t)SAT_U16(Stats.OverrunCount) << 16U) | SAT_U16(Stats.SkippedTriggerCount),
+                         ((uint32_t)SAT_U16(Stats.LateConversionCount) << 16U) | SAT_U16(Stats.WorstLatencyUs));
+}
+
+/**
+  * @brief Sends the bus load of the last window, refer to TX_BUS_LOAD_ID.
+  * @param  None
+  * @retval None
+  */
+static void App_SendBusLoad(void)
+{
+    CAN_BusLoad_Typedef Load;
+
+    MID_CAN_GetBusLoad(&Load);
+
+    MID_CAN_SendCANFrame(TX_BUS_LOAD_MSG,
+                         ((uint32_t)Load.TxLoad << 16U) | Load.RxLoad,
+                         ((uint32_t)Load.PeakLoad << 16U) | ((uint32_t)Load.MaxTxErrCnt << 8U) | Load.MaxRxErrCnt);
+}
+
+/**
+  * @brief Callback triggered by the timer to initiate sensor read process.
+  *        The sensor middleware sets the state to BUSY and accounts for
+  *        overruns and skipped triggers.
   * @param  None
   * @retval None
   */
-static void App_ReceiveMessageNotification(void)
+static void App_TriggerSensor_Notification(void)
+{
+    MID_Trigger_ReadProcess();
+}
+
+/**
+  * @brief Callback to signal that sensor data acquisition is complete.
+  *        Sets the sensor state to READY_TO_READ. In low-latency mode the
+  *        sample is processed and sent from here while streaming.
+  * @param  None
+  * @retval None
+  */
+static void App_Sensor_Notification(void)
+{
+    uint16_t Value      = 0U;
+    uint32_t SampleTime = 0U;
+
+    MID_Set_DataSensorState(READY_TO_READ);
+
+    /* Read here in every mode, the main loop takes this value with MID_Sensor_TakeSample */
+    Value = MID_Read_RotationValue();
+
+    if (g_isValueRequested == true)
+    {
+        g_isValueRequested = false;
+        /* Read back with its sample time as one pair */
+        (void)MID_Sensor_GetLatestSample(&Value, &SampleTime);
+        App_SendValueReply(Value, SampleTime);
+
+        if (g_current_state == STATE_STOP)
+        {
+            /* Polled while streaming is stopped, the main loop does not read the result */
+            MID_Set_DataSensorState(IDLE);
+        }
+    }
+
+    /* Only while streaming: a conversion started by a get-value request in
+     * STATE_STOP must not send a rotation frame.
+     * The mode is read once per sample, here: a sample processed here is never
+     * left READY_TO_READ, so a toggle between two samples cannot hand the same
+     * sample to the main loop too. */
+    if ((g_isLowLatencyMode == true) && (g_current_state == STATE_ACTIVE))
+    {
+        MID_Set_DataSensorState(IDLE);
+        App_ProcessSample(Value);
+    }
+}
+
+/**
+  * @brief Handles a get-value request, called from the CAN Rx ISR.
+  *        The latest sample is answered from here, so the reply is queued within
+  *        the Rx ISR: no loops besides the Tx queue scan, and no waits. A fresh
+  *        request, or a request before the first sample, starts a conversion
+  *        and is answered from the ADC ISR once it completes, a conversion
+  *        already running when the request arrives answers it. Both work while
+  *        streaming is stopped, so a master can poll instead of streaming.
+  * @param  Mode: RX_MSG_GET_VALUE_LATEST_DATA or RX_MSG_GET_VALUE_FRESH_DATA
+  * @retval None
+  */
+static void App_ValueRequest(uint32_t Mode)
 {
-    if (MID_CheckCommingMessageEvent(RX_CONNECTION_MB) == CAN_MSG_RECEIVED)
+    uint16_t Value      = 0U;
+    uint32_t SampleTime = 0U;
+
+    if ((Mode != RX_MSG_GET_VALUE_FRESH_DATA) && (MID_Sensor_GetLatestSample(&Value, &SampleTime) == true))
+    {
+        App_SendValueReply(Value, SampleTime);
+    }
+    else
     {
-          MID_CAN_ReceiveMessage(RX_CONNECTION_MB, &Data_Receive);
-          MID_CAN_SendCANMessage(TX_CONFIRM_CONNECTION_MB, TX_MSG_CONFIRM_CONNECTION_DATA);
-          MID_ClearMessageCommingEvent(RX_CONNECTION_MB);
+        g_isValueRequested = true;
+
+        /* A conversion already running answers the request */
+        (void)MID_Trigger_RequestRead();
     }
+}
+
+/**
+  * @brief Sends a get-value reply, laid out as TX_MSG_ROTATION_DATA_ID.
+  *        The streamed value and its change rule are not affected.
+  * @param  Value: rotation value
+  * @param  SampleTime: LPIT ticks at which the value was sampled
+  * @retval None
+  */
+static void App_SendValueReply(uint16_t Value, uint32_t SampleTime)
+{
+    uint32_t Flags      = 0U;
+    uint32_t GlobalTime = 0U;
 
-    if (MID_CheckCommingMessageEvent(RX_STOPOPR_MB) == CAN_MSG_RECEIVED)
+    if (MID_TimeSync_GetGlobalTime(SampleTime, &GlobalTime) == true)
     {
-          MID_CAN_ReceiveMessage(RX_STOPOPR_MB, &Data_Receive);
+        Flags = TX_ROTATION_FLAG_TIME_VALID;
+    }
+
+    (void)MID_CAN_SendCANFrame(TX_VALUE_REPLY_MSG, Flags | Value, GlobalTime);
+}
+
+/**
+  * @brief Applies the change rule to a new sample and sends it
+  *        when it differs enough from the last sent value, stamped with
+  *        the global time of the sample once the node is synchronized.
+  * @param  Value: new rotation value
+  * @retval None
+  */
+static void App_ProcessSample(uint16_t Value)
+{
+    uint32_t Flags      = 0U;
+    uint32_t SampleTime = 0U;
 
-          if (Data_Receive.Data == RX_MSG_STOP_OPR_DATA)
-          {
-              g_current_state = STATE_STOP;
-          }
-          else if (Data_Receive.Data == RX_MSG_RESUME_OPR_DATA)
-          {
-              g_current_state = STATE_ACTIVE;
-          }
-          else
-          {
-              /* Do nothing */
-          }
+    Cur_Sensor_Value = Value;
 
-          MID_ClearMessageCommingEvent(RX_STOPOPR_MB);
+    Delta = ABS(Cur_Sensor_Value, Pre_Sensor_Value);
+
+    if (Delta > CHANGE_THRESHOLD)
+    {
+        if (MID_TimeSync_GetGlobalTime(MID_Sensor_GetSampleTimestamp(), &SampleTime) == true)
+        {
+            Flags = TX_ROTATION_FLAG_TIME_VALID;
+        }
+
+        /* On back-pressure the value is kept as unsent and retried with the next sample.
+         * A throttled value counts as sent: the held frame is updated with every newer one */
+        if (MID_CAN_SendCANFrame(TX_ROTATION_DATA_MSG, Flags | Cur_Sensor_Value, SampleTime) != CAN_TX_QUEUE_FULL)
+        {
+            Pre_Sensor_Value = Cur_Sensor_Value;
+        }
     }
+}
+
+/**
+  * @brief Appends a sample to the current batch as a delta to the previous
+  *        sample and sends the batch when a flush rule applies.
+  * @param  Value: new rotation value
+  * @retval None
+  */
+static void App_BatchSample(uint16_t Value)
+{
+    int32_t Step = (int32_t)Value - (int32_t)g_batchLastValue;
+    bool Urgent = ((Step > APP_BATCH_URGENT_DELTA) || (Step < -APP_BATCH_URGENT_DELTA));
 
-    if (MID_CheckCommingMessageEvent(RX_CONFIRM_DATA_MB) == CAN_MSG_RECEIVED)
+    /* The step does not fit a delta: close the batch, the sample starts the next one */
+    if ((g_batch.Count != 0U) && ((Step > INT8_MAX) || (Step < INT8_MIN)))
     {
-          MID_ClearMessageCommingEvent(RX_CONFIRM_DATA_MB);
+        App_BatchFlush();
     }
 
-    if (MID_CheckCommingMessageEvent(RX_PING_MSG_MB) == CAN_MSG_RECEIVED)
+    if (g_batch.Count == 0U)
+    {
+        g_batch.Sequence = g_batchSequence;
+        g_batch.First    = Value;
+        MID_SwTimer_Start(g_batchTimerId, APP_BATCH_MAX_LATENCY_MS, SW_TIMER_ONE_SHOT);
+    }
+    else
     {
-          MID_CAN_ReceiveMessage(RX_PING_MSG_MB, &Data_Receive);
-          MID_CAN_SendCANMessage(TX_CONFIRM_PING_MB, TX_MSG_CONFIRM_CONNECTION_DATA);
-          MID_ClearMessageCommingEvent(RX_PING_MSG_MB);
+        g_batch.Delta[g_batch.Count - 1U] = (int8_t)Step;
+    }
+
+    g_batch.Count++;
+    g_batchSequence++;
+    g_batchLastValue = Value;
+
+    if ((g_batch.Count == APP_BATCH_SIZE) || (Urgent == true))
+    {
+        App_BatchFlush();
     }
 }
 
 /**
-  * @brief Callback triggered by the timer to initiate sensor read process.
-  *        Sets the sensor state to BUSY and starts the read process.
+  * @brief Sends the current batch, if any. Called on a flush rule and by the
+  *        latency timer. On back-pressure the batch is dropped, the receiver
+  *        sees the gap in the sequence numbers.
   * @param  None
   * @retval None
   */
-static void App_TriggerSensor_Notification(void)
+static void App_BatchFlush(void)
 {
-    MID_Set_DataSensorState(BUSY);
-    MID_Trigger_ReadProcess();
+    uint32_t Data0 = 0U;
+    uint32_t Data1 = 0U;
+    uint8_t  i     = 0U;
+
+    if (g_batch.Count != 0U)
+    {
+        MID_SwTimer_Stop(g_batchTimerId);
+
+        Data0 = ((uint32_t)g_batch.Sequence << 24U) | ((uint32_t)g_batch.Count << 16U) | g_batch.First;
+        for (i = 0U; i < (g_batch.Count - 1U); i++)
+        {
+            Data1 |= (uint32_t)(uint8_t)g_batch.Delta[i] << (24U - (8U * i));
+        }
+
+        (void)MID_CAN_SendCANFrame(TX_ROTATION_BATCH_MSG, Data0, Data1);
+
+        g_batch.Count = 0U;
+    }
 }
 
 /**
-  * @brief Callback to signal that sensor data acquisition is complete.
-  *        Sets the sensor state to READY_TO_READ.
+  * @brief Transmit confirmation, paces the ISO-TP consecutive frames.
+  * @param  Tx_Msg: Tx message sent
+  * @param  TimeStamp: time the frame was on the bus
+  * @retval None
+  */
+static void App_TxConfirmNotification(uint8_t Tx_Msg, uint32_t TimeStamp)
+{
+    (void)TimeStamp;
+
+    MID_IsoTp_OnTxConfirm(Tx_Msg);
+}
+
+/**
+  * @brief Handles a request received on an ISO-TP channel, called from the CAN ISR.
+  * @param  Channel: ISO-TP channel
+  * @param  Data: request, byte 0 is the service
+  * @param  Length: request length
+  * @retval None
+  */
+static void App_IsoTpReceiveNotification(uint8_t Channel, const uint8_t *Data, uint16_t Length)
+{
+    if ((Channel == APP_ISOTP_CHANNEL) && (Length != 0U) && (Data[0] == APP_SERVICE_STATS_DUMP))
+    {
+        App_SendStatsDump();
+    }
+    else if (Channel == BOOT_ISOTP_CHANNEL)
+    {
+        MID_Boot_OnRequest(Data, Length);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief End of an ISO-TP transfer, releases the dump or the boot response buffer.
+  * @param  Channel: ISO-TP channel
+  * @param  Result: refer to @defgroup ISO-TP result
+  * @retval None
+  */
+static void App_IsoTpTxDoneNotification(uint8_t Channel, uint8_t Result)
+{
+    (void)Result;
+
+    if (Channel == APP_ISOTP_CHANNEL)
+    {
+        g_isDumpPending = false;
+    }
+    else if (Channel == BOOT_ISOTP_CHANNEL)
+    {
+        MID_Boot_OnTxDone();
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief Sends the full, unsaturated statistics as one ISO-TP message.
+  *        A request while the previous dump is still being sent is ignored.
   * @param  None
   * @retval None
   */
-static void App_Sensor_Notification(void)
+static void App_SendStatsDump(void)
 {
-    MID_Set_DataSensorState(READY_TO_READ);
+    SensorStats_Typedef    Sensor;
+    CAN_RxStats_Typedef    Rx;
+    CAN_ErrorStats_Typedef Error;
+    uint32_t Words[APP_STATS_DUMP_WORDS];
+    uint8_t  i = 0U;
+
+    if (g_isDumpPending == true)
+    {
+        return;
+    }
+
+    MID_Sensor_GetStats(&Sensor);
+    MID_CAN_GetRxStats(&Rx);
+    MID_CAN_GetErrorStats(&Error);
+
+    Words[0]  = Sensor.OverrunCount;
+    Words[1]  = Sensor.SkippedTriggerCount;
+    Words[2]  = Sensor.LateConversionCount;
+    Words[3]  = Sensor.WorstLatencyUs;
+    Words[4]  = Rx.Received;
+    Words[5]  = Rx.Warnings;
+    Words[6]  = Rx.Overflows;
+    Words[7]  = Error.Warnings;
+    Words[8]  = Error.ErrorPassive;
+    Words[9]  = Error.BusOffs;
+    Words[10] = Error.Recoveries;
+    Words[11] = Error.Requeued;
+    Words[12] = Error.MaxRecoveryUs;
+
+    g_dumpBuffer[0] = APP_SERVICE_STATS_DUMP + APP_SERVICE_RESPONSE;
+    for (i = 0U; i < APP_STATS_DUMP_WORDS; i++)
+    {
+        g_dumpBuffer[1U + (4U * i)] = (uint8_t)(Words[i] >> 24U);
+        g_dumpBuffer[2U + (4U * i)] = (uint8_t)(Words[i] >> 16U);
+        g_dumpBuffer[3U + (4U * i)] = (uint8_t)(Words[i] >> 8U);
+        g_dumpBuffer[4U + (4U * i)] = (uint8_t)Words[i];
+    }
+
+    g_isDumpPending = true;
+    if (MID_IsoTp_Send(APP_ISOTP_CHANNEL, g_dumpBuffer, sizeof(g_dumpBuffer)) != ISOTP_OK)
+    {
+        g_isDumpPending = false;
+    }
 }
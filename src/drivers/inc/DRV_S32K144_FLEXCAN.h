@@ -33,8 +33,25 @@
 #define FLEXCAN_PSEG2_MIN 1U     /* minimum numbers of time quanta for phase segment 2*/
 #define FLEXCAN_PSEG2_MAX 7U     /* maximum numbers of time quanta for phase segment 2*/
 #define FLEXCAN_RJW_MAX 3U       /* maximum numbers of time quanta for RJW*/
+#define FLEXCAN_SAMPLE_POINT_DEFAULT 80U /* sample point in % when the config leaves it 0 */
+
+/* Boundary value of CAN FD data phase time segments (FDCBT) */
+#define FLEXCAN_FD_PRESDIV_MAX 1023U /* maximum value for data phase prescaler */
+#define FLEXCAN_FD_NUM_TQ_MIN 5U     /* minimum numbers of time quanta per data bit time*/
+#define FLEXCAN_FD_NUM_TQ_MAX 48U    /* maximum numbers of time quanta per data bit time*/
+#define FLEXCAN_FD_PROPSEG_MAX 31U   /* maximum value for data phase propagation segment*/
+#define FLEXCAN_FD_PSEG1_MAX 7U      /* maximum value for data phase phase segment 1*/
+#define FLEXCAN_FD_PSEG2_MIN 1U      /* minimum value for data phase phase segment 2*/
+#define FLEXCAN_FD_PSEG2_MAX 7U      /* maximum value for data phase phase segment 2*/
+#define FLEXCAN_FD_RJW_MAX 7U        /* maximum value for data phase RJW*/
+#define FLEXCAN_FD_TDCOFF_MAX 31U    /* maximum transceiver delay compensation offset*/
 
 /* FLEXCAN_Mb_Masks FLEXCAN Message Buffer Masks */
+#define FLEXCAN_MB_PRIO_MASK (0xE0000000U) /* Local priority, with MCR LPRIOEN */
+#define FLEXCAN_MB_PRIO_SHIFT 29U
+#define FLEXCAN_MB_PRIO_MAX 7U
+#define FLEXCAN_MB_PRIO(x) (((uint32_t)((uint32_t)(x) << FLEXCAN_MB_PRIO_SHIFT)) & (FLEXCAN_MB_PRIO_MASK))
+
 #define FLEXCAN_MB_ID_STD_MASK (0x1FFC0000U)
 #define FLEXCAN_MB_ID_STD_SHIFT 18U
 #define FLEXCAN_MB_ID_STD_WIDTH 11U
@@ -43,6 +60,11 @@
 #define FLEXCAN_MB_ID_EXT_SHIFT 0U
 #define FLEXCAN_MB_ID_EXT_WIDTH 18U
 
+/* CAN FD frame format bits of the CS word */
+#define FLEXCAN_MB_EDL_MASK (0x80000000U) /* Extended data length: CAN FD frame */
+#define FLEXCAN_MB_BRS_MASK (0x40000000U) /* Bit rate switch in the data phase */
+#define FLEXCAN_MB_ESI_MASK (0x20000000U) /* Error state of the transmitter */
+
 #define FLEXCAN_MB_IDE_MASK (0x200000U)
 #define FLEXCAN_MB_IDE_SHIFT 21U
 #define FLEXCAN_MB_IDE_WIDTH 1U
@@ -52,6 +74,8 @@
 #define FLEXCAN_MB_DLC_WIDTH 4U
 #define FLEXCAN_MB_DLC(x) (((uint32_t)((uint32_t)(x) << FLEXCAN_MB_DLC_SHIFT)) & (FLEXCAN_MB_DLC_MASK))
 
+#define FLEXCAN_MB_TIME_STAMP_MASK (0xFFFFU) /* Free running timer captured when the frame was on the bus */
+
 #define FLEXCAN_MB_CODE_MASK (0xF000000U)
 #define FLEXCAN_MB_CODE_SHIFT 24U
 #define FLEXCAN_MB_CODE_WIDTH 4U
@@ -59,6 +83,10 @@
 
 #define FLEXCAN_MAX_MB_NUM 32U /* Maximum number of Mbs in FLEXCAN module of S32K144 */
 
+#define FLEXCAN_CLASSIC_DATA_LENGTH 8U /* Largest classic CAN payload in bytes */
+#define FLEXCAN_MB_DATA_WORDS_MAX 16U  /* Largest payload in words: 64 bytes CAN FD */
+#define FLEXCAN_FD_INSTANCE 0U         /* Only FlexCAN0 of S32K144 supports CAN FD */
+
 /* FlexCAN message buffer CODE FOR Tx buffers */
 enum
 {
@@ -87,6 +115,39 @@ enum
 /* CAN standard: 4 words = 1 CS + 1 ID + 2 data (=8 bytes)*/
 #define MESSAGE_BUFFER_SIZE 4U
 
+/* Words of CS + ID ahead of the payload in every MB, classic or FD */
+#define MESSAGE_BUFFER_HEADER_SIZE 2U
+
+/* Legacy Rx FIFO: output at MB0, filter table from MB6, 6 frames deep */
+#define FLEXCAN_RX_FIFO_OUTPUT_MB 0U
+#define FLEXCAN_RX_FIFO_FILTER_MB 6U
+#define FLEXCAN_RX_FIFO_DEPTH 6U
+#define FLEXCAN_RX_FIFO_MAX_FILTERS 32U /* elements covered by individual masks RXIMR0..31 */
+
+/* Rx FIFO interrupt flags in IFLAG1 */
+#define FLEXCAN_RX_FIFO_FRAME_AVAIL_IDX 5U
+#define FLEXCAN_RX_FIFO_WARNING_IDX 6U
+#define FLEXCAN_RX_FIFO_OVERFLOW_IDX 7U
+#define FLEXCAN_RX_FIFO_INT_MASK ((1UL << FLEXCAN_RX_FIFO_FRAME_AVAIL_IDX) | (1UL << FLEXCAN_RX_FIFO_WARNING_IDX) | (1UL << FLEXCAN_RX_FIFO_OVERFLOW_IDX))
+
+/* Mailboxes taken by the Rx FIFO and a filter table of n elements (RFFN = (n - 1) / 8) */
+#define FLEXCAN_RX_FIFO_OCCUPIED_MB(n) (8U + (2U * (((n) - 1U) / 8U)))
+
+/* Rx FIFO ID filter element, format A (one full ID per element) */
+#define FLEXCAN_RX_FIFO_ID_RTR_MASK (0x80000000U)
+#define FLEXCAN_RX_FIFO_ID_IDE_MASK (0x40000000U)
+#define FLEXCAN_RX_FIFO_ID_STD_MASK (0x3FF80000U)
+#define FLEXCAN_RX_FIFO_ID_STD_SHIFT 19U
+#define FLEXCAN_RX_FIFO_ID_EXT_MASK (0x3FFFFFFEU)
+#define FLEXCAN_RX_FIFO_ID_EXT_SHIFT 1U
+
+/* Error and bus state events, the ESR1 interrupt flags passed to the error callback */
+#define FLEXCAN_ERROR_EVENT_BUS_OFF (FLEXCAN_ESR1_BOFFINT_MASK)          /* Tx error counter passed 255 */
+#define FLEXCAN_ERROR_EVENT_BUS_OFF_DONE (FLEXCAN_ESR1_BOFFDONEINT_MASK) /* Recovered from bus-off */
+#define FLEXCAN_ERROR_EVENT_TX_WARNING (FLEXCAN_ESR1_TWRNINT_MASK)       /* Tx error counter reached 96 */
+#define FLEXCAN_ERROR_EVENT_RX_WARNING (FLEXCAN_ESR1_RWRNINT_MASK)       /* Rx error counter reached 96 */
+#define FLEXCAN_ERROR_EVENT_MASK (FLEXCAN_ERROR_EVENT_BUS_OFF | FLEXCAN_ERROR_EVENT_BUS_OFF_DONE | FLEXCAN_ERROR_EVENT_TX_WARNING | FLEXCAN_ERROR_EVENT_RX_WARNING)
+
 /* FlexCAN operation modes */
 typedef enum
 {
@@ -104,6 +165,14 @@ typedef enum
     FLEXCAN_IN_FREEZE_MODE
 } flexcan_freeze_mode_status_t;
 
+/* FlexCAN status of operations that wait on the module */
+typedef enum
+{
+    FLEXCAN_STATUS_SUCCESS,
+    FLEXCAN_STATUS_TIMEOUT,    /* FRZACK did not follow the freeze request in time */
+    FLEXCAN_STATUS_INVALID_PARAM /* Configuration rejected, nothing written */
+} flexcan_status_t;
+
 /* FlexCAN bitrate related structure */
 typedef struct
 {
@@ -114,6 +183,24 @@ typedef struct
     uint32_t phaseSeg2;
 } flexcan_time_segment_t;
 
+/* Precomputed bit timing, see DRV_S32K144_FLEXCAN_TimingTable.h */
+typedef struct
+{
+    uint32_t clkFreq;
+    uint32_t bitrate;
+    uint32_t samplePoint;
+    flexcan_time_segment_t timeSeg;
+} flexcan_timing_entry_t;
+
+/* FLEXCAN CAN FD payload size of every MB, the value is written to FDCTRL[MBDSR0] */
+typedef enum
+{
+    FLEXCAN_PAYLOAD_SIZE_8 = 0U,  /* 32 MBs */
+    FLEXCAN_PAYLOAD_SIZE_16 = 1U, /* 21 MBs */
+    FLEXCAN_PAYLOAD_SIZE_32 = 2U, /* 12 MBs */
+    FLEXCAN_PAYLOAD_SIZE_64 = 3U  /*  7 MBs */
+} flexcan_fd_payload_size_t;
+
 /*FLEXCAN clock source*/
 typedef enum
 {
@@ -128,6 +215,13 @@ typedef enum
     FLEXCAN_RX_MASK_INDIVIDUAL
 } flexcan_rx_mask_type_t;
 
+/* Tx arbitration among pending mailboxes, CTRL1 LBUF */
+typedef enum
+{
+    FLEXCAN_TX_ARB_LOWEST_ID,    /* Lowest PRIO:ID first, PRIO counts with localPriority */
+    FLEXCAN_TX_ARB_LOWEST_BUFFER /* Lowest mailbox index first */
+} flexcan_tx_arbitration_t;
+
 /* FLEXCAN message buffer id type */
 typedef enum
 {
@@ -148,16 +242,55 @@ typedef struct
     uint32_t cs;
     uint32_t code;
     uint32_t msgId;
-    uint32_t data[2];
-    uint32_t dataLength;
+    uint32_t data[FLEXCAN_MB_DATA_WORDS_MAX];
+    uint32_t dataLength; /* in bytes, frames above 8 bytes are CAN FD (cs carries EDL/BRS on receive) */
+    uint16_t timeStamp;  /* TIME_STAMP of a received frame, see DRV_FLEXCAN_ExtendTimestamp */
 } flexcan_mb_t;
 
+/* Zero-copy view of a received frame: the header is decoded at lock time, the payload stays in
+ * MB RAM and is read with FLEXCAN_MB_VIEW_WORD until the mailbox is unlocked */
+typedef struct
+{
+    volatile const uint32_t *mb;
+    uint32_t cs;
+    uint32_t msgId;
+    uint32_t dataLength; /* in bytes */
+} flexcan_mb_view_t;
+
+/* Payload word i of a locked mailbox, bytes 4i..4i+3, most significant byte first on the bus */
+#define FLEXCAN_MB_VIEW_WORD(view, i) ((view)->mb[MESSAGE_BUFFER_HEADER_SIZE + (i)])
+
+/* TIME_STAMP of a locked mailbox */
+#define FLEXCAN_MB_VIEW_TIMESTAMP(view) ((uint16_t)((view)->cs & FLEXCAN_MB_TIME_STAMP_MASK))
+
 /*Information needed for internal handling of a given MB*/
 // typedef struct
 // {
 //     flexcan_mb_t *data; /* The FlexCAN MB structure */
 // } flexcan_mb_handle_t;
 
+/* FLEXCAN Rx FIFO ID filter element */
+typedef struct
+{
+    flexcan_mb_id_type_t idType;
+    uint32_t id;
+} flexcan_rx_fifo_id_filter_t;
+
+/* FLEXCAN Rx FIFO config structure */
+typedef struct
+{
+    const flexcan_rx_fifo_id_filter_t *idFilterTable;
+    uint8_t idFilterNum; /* 1..FLEXCAN_RX_FIFO_MAX_FILTERS */
+} flexcan_rx_fifo_config_t;
+
+/* FLEXCAN Rx FIFO events */
+typedef enum
+{
+    FLEXCAN_RX_FIFO_FRAME,    /* A frame was read from the FIFO output */
+    FLEXCAN_RX_FIFO_WARNING,  /* The FIFO went from 4 to 5 frames */
+    FLEXCAN_RX_FIFO_OVERFLOW  /* A frame was lost because the FIFO was full */
+} flexcan_rx_fifo_event_t;
+
 /* FLEXCAN Interrupt Enable/ Disable*/
 typedef enum
 {
@@ -165,14 +298,38 @@ typedef enum
     FLEXCAN_INTERRUPT_ENABLE
 } flexcan_interrupt_t;
 
+/* Fault confinement state, ESR1 FLTCONF */
+typedef enum
+{
+    FLEXCAN_ERROR_ACTIVE = 0U,
+    FLEXCAN_ERROR_PASSIVE = 1U,
+    FLEXCAN_BUS_OFF = 2U
+} flexcan_fault_state_t;
+
+/* Fault confinement state and error counters */
+typedef struct
+{
+    flexcan_fault_state_t faultState;
+    uint8_t txErrCnt;
+    uint8_t rxErrCnt;
+} flexcan_error_state_t;
+
 /* FLEXCAN module config structure */
 typedef struct
 {
     flexcan_clock_source_t clkSrc;
     uint32_t flexcanClkFreq;
     uint32_t bitrate;
+    uint32_t samplePoint;                  /* Nominal sample point in %, 0 selects FLEXCAN_SAMPLE_POINT_DEFAULT */
     flexcan_operation_modes_t flexcanMode;
     flexcan_rx_mask_type_t rxMaskType;
+    uint8_t fdEnable;                      /* 1: ISO CAN FD, FLEXCAN_FD_INSTANCE only */
+    uint32_t bitrateFd;                    /* Data phase bitrate, used with bitrateSwitch */
+    uint8_t bitrateSwitch;                 /* 1: FD frames are sent with BRS at bitrateFd */
+    flexcan_fd_payload_size_t payloadSize; /* Payload size of every MB in FD mode */
+    flexcan_tx_arbitration_t txArbitration;
+    uint8_t localPriority;                 /* 1: MCR LPRIOEN, the PRIO bits of the ID word rank pending frames */
+    uint8_t abortEnable;                   /* 1: MCR AEN, pending frames are withdrawn with DRV_FLEXCAN_AbortTxMb */
 } flexcan_module_config_t;
 
 /* FLEXCAN handle structure */
@@ -180,7 +337,10 @@ typedef struct
 {
     flexcan_mb_t * mbs[FLEXCAN_MAX_MB_NUM];
     void (*mb_callback)(void);
-    void (*bus_off_callback)(void);
+    void (*error_callback)(uint32_t events); /* events: FLEXCAN_ERROR_EVENT_x flags, already cleared */
+    void (*mb_handler[FLEXCAN_MAX_MB_NUM])(uint8_t mbIdx); /* Per mailbox handler, NULL falls back to mb_callback */
+    void (*rx_fifo_callback)(flexcan_rx_fifo_event_t event, const flexcan_mb_view_t *frame); /* frame is NULL except for FLEXCAN_RX_FIFO_FRAME */
+    uint32_t rxFifoMask;                   /* Flags owned by the Rx FIFO, 0 when it is disabled */
 } flexcan_handle_t;
 
 /*******************************************************************************
@@ -195,13 +355,29 @@ void DRV_FLEXCAN_DisableMbInt(uint8_t instance, uint8_t mbIdx);
 
 uint8_t DRV_FLEXCAN_GetMbIntFlag(uint8_t instance, uint8_t mbIdx);
 
+/* Returns the pending and enabled mailbox flags in one read of IFLAG1 */
+uint32_t DRV_FLEXCAN_GetMbIntFlags(uint8_t instance);
+
 void DRV_FLEXCAN_ClearMbIntFlag(uint8_t instance, uint8_t mbIdx);
 
-void DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan_handle_t *handle);
+/* Clears the flags of all mailboxes in mbMask with a single write-1-to-clear access */
+void DRV_FLEXCAN_ClearMbIntFlags(uint8_t instance, uint32_t mbMask);
 
-void DRV_FLEXCAN_SetRxMbGlobalMask(uint8_t instance, flexcan_mb_id_type_t idType, uint32_t mask);
+/* Returns FLEXCAN_STATUS_TIMEOUT if freeze mode could not be entered, bit timing and mailboxes
+ * are not configured then. The handle is registered in any case. */
+flexcan_status_t DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan_handle_t *handle);
 
-void DRV_FLEXCAN_SetRxMbIndividualMask(uint8_t instance, flexcan_mb_id_type_t idType, uint8_t mbIdx, uint32_t mask);
+/* Configuration transaction: enters freeze mode once, every mask, mailbox, FIFO and interrupt
+ * setting applied until the matching DRV_FLEXCAN_CommitConfig runs without its own freeze cycle.
+ * Calls may nest, the outermost commit leaves freeze mode. On FLEXCAN_STATUS_TIMEOUT nothing is
+ * entered and no commit is expected. */
+flexcan_status_t DRV_FLEXCAN_BeginConfig(uint8_t instance);
+
+flexcan_status_t DRV_FLEXCAN_CommitConfig(uint8_t instance);
+
+flexcan_status_t DRV_FLEXCAN_SetRxMbGlobalMask(uint8_t instance, flexcan_mb_id_type_t idType, uint32_t mask);
+
+flexcan_status_t DRV_FLEXCAN_SetRxMbIndividualMask(uint8_t instance, flexcan_mb_id_type_t idType, uint8_t mbIdx, uint32_t mask);
 
 void DRV_FLEXCAN_ConfigRxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *rx_mb, uint32_t mb_id);
 
@@ -209,12 +385,79 @@ void DRV_FLEXCAN_Receive(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data);
 
 void DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data);
 
+/* Locks an Rx mailbox and maps it into view, waiting while the controller updates it.
+ * Returns the CODE of the mailbox, with the BUSY bit still set if the update did not end
+ * within a bounded number of polls: the view is then not consistent. Keep the lock window
+ * short: a frame matching a locked mailbox is not stored in it. */
+uint8_t DRV_FLEXCAN_LockRxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_view_t *view);
+
+/* Clears the mailbox flag and releases the lock taken by DRV_FLEXCAN_LockRxMb */
+void DRV_FLEXCAN_UnlockRxMb(uint8_t instance, uint8_t mbIdx);
+
+/* Returns the number of MBs available with the configured payload size */
+uint8_t DRV_FLEXCAN_GetMbNum(uint8_t instance);
+
+/* Enables the legacy Rx FIFO with a format A ID filter table. Not available in CAN FD mode. The FIFO and the table take
+ * mailboxes 0..FLEXCAN_RX_FIFO_OCCUPIED_MB(idFilterNum) - 1, every element is matched on the full ID.
+ * FLEXCAN_STATUS_INVALID_PARAM without filters or in CAN FD mode */
+flexcan_status_t DRV_FLEXCAN_ConfigRxFifo(uint8_t instance, const flexcan_rx_fifo_config_t *config);
+
+/* Enables the Rx FIFO interrupts. Each interrupt drains up to FLEXCAN_RX_FIFO_DEPTH frames and
+ * calls cb_ptr once per frame with a view of the FIFO output, which advances when cb_ptr returns.
+ * Warning and overflow are reported first. */
+void DRV_FLEXCAN_RegisterRxFifoCallback(uint8_t instance, void (*cb_ptr)(flexcan_rx_fifo_event_t event, const flexcan_mb_view_t *frame));
+
 void DRV_FLEXCAN_ConfigTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *tx_mb, uint32_t mb_id);
 
 void DRV_FLEXCAN_Transmit(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data);
 
+/* Writes ID, DLC and data of a frame into an inactive Tx mailbox and starts the transmission.
+ * In CAN FD mode a frame longer than 8 bytes is sent as an FD frame, padded to the next valid
+ * FD length and truncated to the MB payload size. */
+void DRV_FLEXCAN_TransmitFrame(uint8_t instance, uint8_t mbIdx, flexcan_mb_id_type_t idType, flexcan_mb_t *data);
+
+/* In-place transmit: the payload words of an inactive Tx mailbox are written through the pointer
+ * returned by DRV_FLEXCAN_GetTxMbPayload, then DRV_FLEXCAN_CommitTxMb writes the ID, pads the
+ * payload up to the DLC length with 0 and starts the transmission. */
+volatile uint32_t *DRV_FLEXCAN_GetTxMbPayload(uint8_t instance, uint8_t mbIdx);
+
+void DRV_FLEXCAN_CommitTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_id_type_t idType, uint32_t msgId, uint32_t dataLength, uint8_t prio);
+
+/* Requests the abort of a pending Tx frame, needs abortEnable. Returns 1 if requested. The
+ * mailbox interrupt follows either way: DRV_FLEXCAN_IsTxMbAborted then tells whether the
+ * frame was withdrawn or had already won arbitration and was sent. */
+uint8_t DRV_FLEXCAN_AbortTxMb(uint8_t instance, uint8_t mbIdx);
+
+uint8_t DRV_FLEXCAN_IsTxMbAborted(uint8_t instance, uint8_t mbIdx);
+
+/* Returns the TIME_STAMP of the last frame sent or received by a mailbox, in CAN bit times
+ * of the free running timer. Read a Tx mailbox before it is refilled. */
+uint16_t DRV_FLEXCAN_GetMbTimestamp(uint8_t instance, uint8_t mbIdx);
+
+/* Free running timer extended to 64 bits, in CAN bit times. The 16-bit TIMER wraps every 65536
+ * bit times, call at least that often to keep the extension, with interrupts masked.
+ * Reading TIMER releases a mailbox locked by DRV_FLEXCAN_LockRxMb. */
+uint64_t DRV_FLEXCAN_GetTimer64(uint8_t instance);
+
+/* Extends the TIME_STAMP of a frame captured less than 65536 bit times ago to the 64-bit
+ * timer of DRV_FLEXCAN_GetTimer64 */
+uint64_t DRV_FLEXCAN_ExtendTimestamp(uint8_t instance, uint16_t timeStamp);
+
 void DRV_FLEXCAN_RegisterMbCallback(uint8_t instance, void (*cb_ptr)(void));
 
-void DRV_FLEXCAN_RegisterBusOffCallback(uint8_t instance, void (*cb_ptr)(void));
+/* Enables the bus-off, bus-off done and Tx/Rx warning interrupts and routes them to cb_ptr,
+ * NULL disables them again. Runs as one configuration transaction. */
+flexcan_status_t DRV_FLEXCAN_RegisterErrorCallback(uint8_t instance, void (*cb_ptr)(uint32_t events));
+
+/* CTRL1 BOFFREC, writable at any time. With automatic recovery disabled the controller stays
+ * bus-off until it is enabled again, then rejoins after 128 occurrences of 11 recessive bits. */
+void DRV_FLEXCAN_SetBusOffRecovery(uint8_t instance, uint8_t automatic);
+
+/* Reads the fault confinement state from ESR1 and the error counters from ECR */
+void DRV_FLEXCAN_GetErrorState(uint8_t instance, flexcan_error_state_t *state);
+
+/* Routes the interrupt of one mailbox to cb_ptr, called with the mailbox index after its flag
+ * is cleared. Mailboxes without a handler raise the Mb callback and keep their flag. */
+void DRV_FLEXCAN_RegisterMbHandler(uint8_t instance, uint8_t mbIdx, void (*cb_ptr)(uint8_t mbIdx));
 
 #endif /* DRV_S32K144_FLEXCAN_H_ */
@@ -0,0 +1,41 @@
+/*
+ *  Filename: DRV_S32K144_FLEXCAN_TimingTable.h
+ *
+ *  Generated by tools/flexcan_timing_gen.py, do not edit.
+ *  Included by DRV_S32K144_FLEXCAN.c only.
+*/
+
+#ifndef DRV_S32K144_FLEXCAN_TIMINGTABLE_H_
+#define DRV_S32K144_FLEXCAN_TIMINGTABLE_H_
+
+/* { clock Hz, bitrate, sample point %, { presDiv, rJumpWidth, propSeg, phaseSeg1, phaseSeg2 } }
+ * Comment: time quanta per bit, resulting sample point, prescaler steps of the runtime search */
+static const flexcan_timing_entry_t g_flexcanTimingTable[] =
+{
+    {  8000000U,  125000U, 75U, {  3U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75 %,   4 steps */
+    {  8000000U,  250000U, 75U, {  1U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75 %,   2 steps */
+    {  8000000U,  500000U, 75U, {  0U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75 %,   1 steps */
+    {  8000000U, 1000000U, 75U, {  0U, 1U, 2U, 1U, 1U}}, /*  8 tq, 75 %,   1 steps */
+    { 40000000U,  125000U, 75U, { 15U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,  16 steps */
+    { 40000000U,  125000U, 80U, { 15U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80 %,  16 steps */
+    { 40000000U,  250000U, 75U, {  7U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,   8 steps */
+    { 40000000U,  250000U, 80U, {  7U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80 %,   8 steps */
+    { 40000000U,  500000U, 75U, {  3U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,   4 steps */
+    { 40000000U,  500000U, 80U, {  3U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80 %,   4 steps */
+    { 40000000U, 1000000U, 75U, {  1U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,   2 steps */
+    { 40000000U, 1000000U, 80U, {  1U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80 %,   2 steps */
+    { 48000000U,  125000U, 75U, { 23U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75 %,  24 steps */
+    { 48000000U,  250000U, 75U, { 11U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75 %,  12 steps */
+    { 48000000U,  500000U, 75U, {  5U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75 %,   6 steps */
+    { 48000000U, 1000000U, 75U, {  2U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75 %,   3 steps */
+    { 80000000U,  125000U, 75U, { 31U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,  32 steps */
+    { 80000000U,  125000U, 80U, { 31U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80 %,  32 steps */
+    { 80000000U,  250000U, 75U, { 15U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,  16 steps */
+    { 80000000U,  250000U, 80U, { 15U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80 %,  16 steps */
+    { 80000000U,  500000U, 75U, {  7U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,   8 steps */
+    { 80000000U,  500000U, 80U, {  7U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80 %,   8 steps */
+    { 80000000U, 1000000U, 75U, {  3U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75 %,   4 steps */
+    { 80000000U, 1000000U, 80U, {  3U, 3U, 7U, 6U, 3U}}  /* 20 tq, 80 %,   4 steps */
+};
+
+#endif /* DRV_S32K144_FLEXCAN_TIMINGTABLE_H_ */
@@ -0,0 +1,63 @@
+/*
+ * DRV_S32K144_FTFC.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef DRV_S32K144_FTFC_H_
+#define DRV_S32K144_FTFC_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include "S32K144.h"
+#include "S32K144_features.h"
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define FTFC_PFLASH_SIZE        FEATURE_FLS_PF_BLOCK_SIZE               /* 512 KB, one block      */
+#define FTFC_SECTOR_SIZE        FEATURE_FLS_PF_BLOCK_SECTOR_SIZE        /* Erase unit              */
+#define FTFC_PHRASE_SIZE        FEATURE_FLS_PF_BLOCK_WRITE_UNIT_SIZE    /* Program unit            */
+#define FTFC_SECTION_MAX_SIZE   FEATURE_FLS_FLEX_RAM_SIZE               /* Program Section buffer  */
+
+/* P-Flash contents at address, read through the memory map */
+#define FTFC_FLASH_PTR(address) ((const uint8_t *)(uintptr_t)(address))
+
+/* Flash command result */
+typedef enum
+{
+    FTFC_STATUS_SUCCESS,
+    FTFC_STATUS_INVALID_PARAM,      /* Address or length not aligned, or outside the P-Flash */
+    FTFC_STATUS_ACCESS_ERROR,       /* FSTAT[ACCERR]: illegal command or address            */
+    FTFC_STATUS_PROTECTION_ERROR,   /* FSTAT[FPVIOL]: protected region                      */
+    FTFC_STATUS_VERIFY_ERROR        /* FSTAT[MGSTAT0]: command completed with an error      */
+} ftfc_status_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/*
+ * The P-Flash is a single block, it cannot be read while a command runs. Each command is launched
+ * and waited for from RAM (section .code_ram) with interrupts masked, as every handler executes from
+ * flash. Interrupts stay masked for one phrase or one section of up to FTFC_SECTION_MAX_SIZE bytes.
+ * A sector erase is suspended about every millisecond so pending interrupts run, then resumed:
+ * sampling, timers and the CAN Rx FIFO are held back for one slice instead of the whole erase.
+ */
+
+/* Erases the 4 KB sector at address, which must be sector aligned */
+ftfc_status_t DRV_FTFC_EraseSector(uint32_t address);
+
+/* Programs one 8-byte phrase at a phrase aligned address */
+ftfc_status_t DRV_FTFC_ProgramPhrase(uint32_t address, const uint8_t *data);
+
+/* Programs length bytes, a multiple of FTFC_PHRASE_SIZE up to FTFC_SECTION_MAX_SIZE, with one Program
+ * Section command from the FlexRAM section buffer. About one command overhead for the whole section
+ * instead of one per phrase. Falls back to phrase programming when FlexRAM is not available as RAM,
+ * i.e. partitioned for EEPROM emulation. */
+ftfc_status_t DRV_FTFC_ProgramSection(uint32_t address, const uint8_t *data, uint16_t length);
+
+#endif /* DRV_S32K144_FTFC_H_ */
@@ -43,6 +43,7 @@ typedef struct
     LPIT_Mode LPIT_OperationMode;       /* LPIT mode, refer to @LPIT_ChannelTypedef */
     Functional_State LPIT_ChainChannel; /* LPIT chain channel */
     Functional_State LPIT_Interupt;     /* LPIT interrupt */
+    Functional_State LPIT_OneShot;      /* Stop the channel after one timeout (TSOI), restart it with DRV_LPIT_StartTimerChannel */
 }LPIT_InitTypedef;
 
 /*******************************************************************************
@@ -88,8 +89,10 @@ void DRV_LPIT_ClearInterruptFlagTimerChannels(uint8_t instance, LPIT_ChannelType
 uint32_t DRV_LPIT_GetCurrentTimerCount(uint8_t instance, LPIT_ChannelTypedef CHx);
 
 /**
-  * @brief  Retrieves the current timer count value for a specified LPIT channel.
-  * @param[in]  CHx: The LPIT channel for which to clear the interrupt flag.
+  * @brief  Sets the reload value of a specified LPIT channel. On a running channel
+  *         the new value is loaded at the next timeout, the current period is not disturbed.
+  * @param[in]  CHx: The LPIT channel to configure.
+  * @param[in]  Val: number of LPIT clock cycles in one period.
   * @retval None
   */
 void DRV_LPIT_SetReloadValue(uint8_t instance, LPIT_ChannelTypedef CHx, uint32_t Val);
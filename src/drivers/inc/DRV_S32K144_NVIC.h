@@ -96,4 +96,27 @@ void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
   */
 uint32_t NVIC_GetPriority(IRQn_Type IRQn);
 
+/**
+  * @brief  Mask all configurable interrupts and return the previous PRIMASK,
+  *         so that critical sections can be nested and used from ISRs
+  * @param  None
+  * @retval Previous PRIMASK value, to be passed to NVIC_ExitCritical
+  */
+uint32_t NVIC_EnterCritical(void);
+
+/**
+  * @brief  Restore the PRIMASK saved by NVIC_EnterCritical
+  * @param  primask: value returned by NVIC_EnterCritical
+  * @retval None
+  */
+void NVIC_ExitCritical(uint32_t primask);
+
+/**
+  * @brief  Start the image whose vector table is at vectorTable as after a reset,
+  *         with every interrupt of the caller disabled
+  * @param  vectorTable: address of the vector table of the image
+  * @retval None, does not return
+  */
+void NVIC_JumpToImage(uint32_t vectorTable);
+
 #endif /* DRV_S32K144_NVIC_H_ */
@@ -5,31 +5,53 @@
  *      Author: Ndhieu131020@gmail.com
 */
 #include "DRV_S32K144_FLEXCAN.h"
+#include "DRV_S32K144_FLEXCAN_TimingTable.h"
 
 /*******************************************************************************
  * Definition
  ******************************************************************************/
 
+/* FRZACK polls before giving up: about 12 ms at 80 MHz, several frames at 125 kbit/s */
+#define FLEXCAN_FREEZE_TIMEOUT_LOOPS (100000U)
+
+/* CS polls while an Rx mailbox is BUSY: the move-in takes a few CAN clock cycles, far fewer than this */
+#define FLEXCAN_MB_BUSY_TIMEOUT_LOOPS (1000U)
+
+/* Mailboxes served by each ORed Mb interrupt vector */
+#define FLEXCAN_MB_0_15_MASK (0x0000FFFFU)
+#define FLEXCAN_MB_16_31_MASK (0xFFFF0000U)
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
-static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan_time_segment_t *timeSeg);
+static uint8_t FLEXCAN_LookupTimeSeg(uint32_t bitrate, uint32_t clkFreq, uint32_t samplePoint, flexcan_time_segment_t *timeSeg);
+static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, uint32_t samplePoint, flexcan_time_segment_t *timeSeg);
+static void FLEXCAN_FdBitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan_time_segment_t *timeSeg);
+static void FLEXCAN_SetFdMode(uint8_t instance, flexcan_module_config_t *config);
+static volatile uint32_t *FLEXCAN_GetMbAddr(uint8_t instance, uint8_t mbIdx);
+static uint8_t FLEXCAN_LengthToDlc(uint32_t length);
+static uint32_t FLEXCAN_DlcToLength(uint32_t cs);
+static void FLEXCAN_ReadMbData(uint8_t instance, volatile const uint32_t *mb, flexcan_mb_t *data);
 static flexcan_freeze_mode_status_t FLEXCAN_GetFreezeMode(uint8_t instance);
-static void FLEXCAN_EnterFreezeMode(uint8_t instance);
-static void FLEXCAN_ExitFreezeMode(uint8_t instance);
-static void FLEXCAN_SetBitrate(uint8_t instance, flexcan_time_segment_t *timeSeg);
+static flexcan_status_t FLEXCAN_EnterFreezeMode(uint8_t instance);
+static flexcan_status_t FLEXCAN_ExitFreezeMode(uint8_t instance);
+static flexcan_status_t FLEXCAN_SetBitrate(uint8_t instance, flexcan_time_segment_t *timeSeg);
 static void FLEXCAN_EnableModule(uint8_t instance);
 static void FLEXCAN_DisableModule(uint8_t instance);
 static void FLEXCAN_SelectClockSource(uint8_t instance, flexcan_clock_source_t clkSrc);
 static uint8_t FLEXCAN_GetMaxMbNum(uint8_t instance);
 static void FLEXCAN_ClearRAM(uint8_t instance);
 static void FLEXCAN_InitMb(uint8_t instance);
-static void FLEXCAN_ConfigRxMaskType(uint8_t instance, flexcan_rx_mask_type_t rxMaskType);
-static void FLEXCAN_SetOperationModes(uint8_t instance, flexcan_operation_modes_t flexcanMode);
+static flexcan_status_t FLEXCAN_ConfigRxMaskType(uint8_t instance, flexcan_rx_mask_type_t rxMaskType);
+static flexcan_status_t FLEXCAN_SetOperationModes(uint8_t instance, flexcan_operation_modes_t flexcanMode);
 uint8_t DRV_FLEXCAN_GetMbIntFlag(uint8_t instance, uint8_t mbIdx);
 void DRV_FLEXCAN_ClearMbIntFlag(uint8_t instance, uint8_t mbIdx);
-static void FLEXCAN_Mb_IRQHandler(uint8_t instance);
-static void FLEXCAN_BusOff_IRQHandler(uint8_t instance);
+void DRV_FLEXCAN_ClearMbIntFlags(uint8_t instance, uint32_t mbMask);
+static void FLEXCAN_RxFifoFilterElement(const flexcan_rx_fifo_id_filter_t *filter, uint32_t *element, uint32_t *mask);
+static void FLEXCAN_MapMb(volatile const uint32_t *mb, uint32_t cs, flexcan_mb_view_t *view);
+static void FLEXCAN_RxFifo_IRQHandler(uint8_t instance, uint32_t flags);
+static void FLEXCAN_Mb_IRQHandler(uint8_t instance, uint32_t mbRange);
+static void FLEXCAN_Error_IRQHandler(uint8_t instance);
 
 /*******************************************************************************
  * Variables
@@ -38,18 +60,51 @@ static void FLEXCAN_BusOff_IRQHandler(uint8_t instance);
 /* Table of base addresses for CAN instances. */
 FLEXCAN_Type *g_flexcanBase[FLEXCAN_INSTANCE_COUNT] = IP_FLEXCAN_BASE_PTRS;
 
+/* Nesting depth of DRV_FLEXCAN_BeginConfig, and whether the outermost one entered freeze mode */
+static uint8_t g_flexcanConfigDepth[FLEXCAN_INSTANCE_COUNT];
+static uint8_t g_flexcanConfigFreeze[FLEXCAN_INSTANCE_COUNT];
+
 /* Pointer to runtime handle structure.*/
 flexcan_handle_t *g_flexcanHandle[FLEXCAN_INSTANCE_COUNT] = {NULL};
 
+/* Payload words of every MB: 2 for classic CAN, up to 16 in CAN FD mode */
+static uint8_t g_flexcanMbDataWords[FLEXCAN_INSTANCE_COUNT];
+
+/* Bit rate switch of the FD frames sent by each instance */
+static uint8_t g_flexcanFdBrs[FLEXCAN_INSTANCE_COUNT];
+
+/* Free running timer extended to 64 bits, the low 16 bits are the last TIMER sample */
+static uint64_t g_flexcanTimer64[FLEXCAN_INSTANCE_COUNT];
+
+/* Payload length in bytes of a CAN FD frame, indexed by DLC */
+static const uint8_t g_flexcanDlcToLength[16U] = {0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
 
 /* INIT */
-static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan_time_segment_t *timeSeg)
+static uint8_t FLEXCAN_LookupTimeSeg(uint32_t bitrate, uint32_t clkFreq, uint32_t samplePoint, flexcan_time_segment_t *timeSeg)
+{
+    uint8_t i = 0U;
+    for (i = 0U; i < (sizeof(g_flexcanTimingTable) / sizeof(g_flexcanTimingTable[0])); i++)
+    {
+        if ((g_flexcanTimingTable[i].clkFreq == clkFreq) && (g_flexcanTimingTable[i].bitrate == bitrate) && (g_flexcanTimingTable[i].samplePoint == samplePoint))
+        {
+            *timeSeg = g_flexcanTimingTable[i].timeSeg;
+            return 1U;
+        }
+    }
+    return 0U;
+}
+
+/* Runtime search, kept for combinations missing from the table.
+ * tools/flexcan_timing_gen.py mirrors it, keep both in step. */
+static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, uint32_t samplePoint, flexcan_time_segment_t *timeSeg)
 {
-    uint32_t tmpBitrate, dBitrate, tmpSample, dSample, tmpPhaseSeg1, tmpPhaseSeg2, tmpPropSeg, tmpPresdiv, tSeg1, tSeg2, numTq;
-    uint32_t dBitrateMin = 1000000U, dSampleMin = 100U, samplePoint = 80U;
+    uint32_t tmpBitrate, dBitrate, tmpSample, dSample, tmpPhaseSeg1, tmpPhaseSeg2, tmpPresdiv, tSeg1, tSeg2, numTq;
+    int32_t tmpPropSeg;
+    uint32_t dBitrateMin = 1000000U, dSampleMin = 100U;
     uint32_t presDiv = 0U, propSeg = 0U, phaseSeg1 = 0U, phaseSeg2 = 0U;
     uint8_t proceedFlag = 1U;
     uint8_t exitFlag = 1U;
@@ -57,9 +112,9 @@ static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan
     {
         proceedFlag = 1U;
         numTq = (clkFreq) / ((bitrate) * (tmpPresdiv + 1U));
-        tmpBitrate = (clkFreq) / ((numTq) * (tmpPresdiv + 1U));
         if (numTq >= FLEXCAN_NUM_TQ_MIN && numTq <= FLEXCAN_NUM_TQ_MAX)
         {
+            tmpBitrate = (clkFreq) / ((numTq) * (tmpPresdiv + 1U));
             tSeg1 = (numTq * samplePoint / 100U) - 1U;
             tSeg2 = numTq - tSeg1 - 1U;
             while (tSeg1 > FLEXCAN_TSEG1_MAX || tSeg2 < FLEXCAN_TSEG2_MIN)
@@ -69,18 +124,19 @@ static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan
             }
             tmpPhaseSeg2 = tSeg2 - 1U;
             tmpPhaseSeg1 = tmpPhaseSeg2;
-            tmpPropSeg = tSeg1 - tmpPhaseSeg1 - 2U;
-            while (tmpPropSeg <= 0U)
+            /* Signed: a low sample point leaves less than PSEG1 + 2 in tSeg1 */
+            tmpPropSeg = (int32_t)tSeg1 - (int32_t)tmpPhaseSeg1 - 2;
+            while ((tmpPropSeg <= 0) && (tmpPhaseSeg1 > 0U))
             {
-                tmpPropSeg = tmpPropSeg + 1U;
+                tmpPropSeg = tmpPropSeg + 1;
                 tmpPhaseSeg1 = tmpPhaseSeg1 - 1U;
             }
-            while (tmpPropSeg > FLEXCAN_PROPSEG_MAX)
+            while (tmpPropSeg > (int32_t)FLEXCAN_PROPSEG_MAX)
             {
-                tmpPropSeg = tmpPropSeg - 1U;
+                tmpPropSeg = tmpPropSeg - 1;
                 tmpPhaseSeg1 = tmpPhaseSeg1 + 1U;
             }
-            if ((tSeg1 > FLEXCAN_TSEG1_MAX) || (tSeg1 < FLEXCAN_TSEG1_MIN) || (tSeg2 > FLEXCAN_TSEG2_MAX) || (tSeg2 < FLEXCAN_TSEG2_MIN) || (tmpPropSeg > FLEXCAN_PROPSEG_MAX) || (tmpPhaseSeg1 > FLEXCAN_PSEG1_MAX) || (tmpPhaseSeg2 > FLEXCAN_PSEG2_MAX) || (tmpPhaseSeg2 < FLEXCAN_PSEG2_MIN))
+            if ((tSeg1 > FLEXCAN_TSEG1_MAX) || (tSeg1 < FLEXCAN_TSEG1_MIN) || (tSeg2 > FLEXCAN_TSEG2_MAX) || (tSeg2 < FLEXCAN_TSEG2_MIN) || (tmpPropSeg <= 0) || (tmpPropSeg > (int32_t)FLEXCAN_PROPSEG_MAX) || (tmpPhaseSeg1 > FLEXCAN_PSEG1_MAX) || (tmpPhaseSeg2 > FLEXCAN_PSEG2_MAX) || (tmpPhaseSeg2 < FLEXCAN_PSEG2_MIN))
             {
                 proceedFlag = 0U;
             }
@@ -94,7 +150,7 @@ static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan
                     dBitrateMin = dBitrate;
                     dSampleMin = dSample;
                     presDiv = tmpPresdiv;
-                    propSeg = tmpPropSeg;
+                    propSeg = (uint32_t)tmpPropSeg;
                     phaseSeg1 = tmpPhaseSeg1;
                     phaseSeg2 = tmpPhaseSeg2;
                     if ((dBitrate == 0U) && (dSample <= 1U))
@@ -119,6 +175,55 @@ static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan
     }
 }
 
+static void FLEXCAN_FdBitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan_time_segment_t *timeSeg)
+{
+    uint32_t tmpPresdiv, numTq, tSeg1, tSeg2, tmpPhaseSeg1, tmpPhaseSeg2, tmpPropSeg;
+    uint32_t samplePoint = 75U;
+    uint8_t exitFlag = 1U;
+    timeSeg->presDiv = 0U;
+    timeSeg->propSeg = 0U;
+    timeSeg->phaseSeg1 = 0U;
+    timeSeg->phaseSeg2 = FLEXCAN_FD_PSEG2_MIN;
+    timeSeg->rJumpWidth = 0U;
+    /* Smallest prescaler giving an exact data bitrate, i.e. the most time quanta per bit */
+    for (tmpPresdiv = 0U; (tmpPresdiv <= FLEXCAN_FD_PRESDIV_MAX) && exitFlag; tmpPresdiv++)
+    {
+        numTq = clkFreq / (bitrate * (tmpPresdiv + 1U));
+        if ((numTq * bitrate * (tmpPresdiv + 1U) == clkFreq) && (numTq >= FLEXCAN_FD_NUM_TQ_MIN) && (numTq <= FLEXCAN_FD_NUM_TQ_MAX))
+        {
+            /* tSeg1 = PROPSEG + PSEG1 and tSeg2 = PSEG2 in time quanta, sync segment excluded */
+            tSeg1 = (numTq * samplePoint / 100U) - 1U;
+            tSeg2 = numTq - tSeg1 - 1U;
+            if (tSeg2 > (FLEXCAN_FD_PSEG2_MAX + 1U))
+            {
+                tSeg1 = tSeg1 + tSeg2 - (FLEXCAN_FD_PSEG2_MAX + 1U);
+                tSeg2 = FLEXCAN_FD_PSEG2_MAX + 1U;
+            }
+            if (tSeg2 < (FLEXCAN_FD_PSEG2_MIN + 1U))
+            {
+                tSeg1 = tSeg1 + tSeg2 - (FLEXCAN_FD_PSEG2_MIN + 1U);
+                tSeg2 = FLEXCAN_FD_PSEG2_MIN + 1U;
+            }
+            tmpPhaseSeg2 = tSeg2 - 1U;
+            tmpPhaseSeg1 = (tmpPhaseSeg2 < (tSeg1 - 1U)) ? tmpPhaseSeg2 : (tSeg1 - 1U);
+            if (tmpPhaseSeg1 > FLEXCAN_FD_PSEG1_MAX)
+            {
+                tmpPhaseSeg1 = FLEXCAN_FD_PSEG1_MAX;
+            }
+            tmpPropSeg = tSeg1 - tmpPhaseSeg1 - 1U;
+            if (tmpPropSeg <= FLEXCAN_FD_PROPSEG_MAX)
+            {
+                timeSeg->presDiv = tmpPresdiv;
+                timeSeg->propSeg = tmpPropSeg;
+                timeSeg->phaseSeg1 = tmpPhaseSeg1;
+                timeSeg->phaseSeg2 = tmpPhaseSeg2;
+                timeSeg->rJumpWidth = (tmpPhaseSeg2 < FLEXCAN_FD_RJW_MAX) ? tmpPhaseSeg2 : FLEXCAN_FD_RJW_MAX;
+                exitFlag = 0U;
+            }
+        }
+    }
+}
+
 static flexcan_freeze_mode_status_t FLEXCAN_GetFreezeMode(uint8_t instance)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
@@ -129,39 +234,125 @@ static flexcan_freeze_mode_status_t FLEXCAN_GetFreezeMode(uint8_t instance)
     return FLEXCAN_OUT_FREEZE_MODE;
 }
 
-static void FLEXCAN_EnterFreezeMode(uint8_t instance)
+static flexcan_status_t FLEXCAN_EnterFreezeMode(uint8_t instance)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t timeout = FLEXCAN_FREEZE_TIMEOUT_LOOPS;
     base->MCR = (base->MCR & ~FLEXCAN_MCR_FRZACK_MASK) | FLEXCAN_MCR_FRZ(1U);
     base->MCR = (base->MCR & ~FLEXCAN_MCR_HALT_MASK) | FLEXCAN_MCR_HALT(1U);
-    while (((base->MCR & FLEXCAN_MCR_FRZACK_MASK) >> FLEXCAN_MCR_FRZACK_SHIFT) != 1U)
+    /* Bounded: FRZACK never comes while the module is disabled or held off the bus */
+    while ((((base->MCR & FLEXCAN_MCR_FRZACK_MASK) >> FLEXCAN_MCR_FRZACK_SHIFT) != 1U) && (timeout != 0U))
     {
+        timeout--;
     }
+    return (FLEXCAN_GetFreezeMode(instance) == FLEXCAN_IN_FREEZE_MODE) ? FLEXCAN_STATUS_SUCCESS : FLEXCAN_STATUS_TIMEOUT;
 }
 
-static void FLEXCAN_ExitFreezeMode(uint8_t instance)
+static flexcan_status_t FLEXCAN_ExitFreezeMode(uint8_t instance)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t timeout = FLEXCAN_FREEZE_TIMEOUT_LOOPS;
     base->MCR = (base->MCR & ~FLEXCAN_MCR_HALT_MASK) | FLEXCAN_MCR_HALT(0U);
     base->MCR = (base->MCR & ~FLEXCAN_MCR_FRZACK_MASK) | FLEXCAN_MCR_FRZ(0U);
-    while (((base->MCR & FLEXCAN_MCR_FRZACK_MASK) >> FLEXCAN_MCR_FRZACK_SHIFT) != 0U)
+    while ((((base->MCR & FLEXCAN_MCR_FRZACK_MASK) >> FLEXCAN_MCR_FRZACK_SHIFT) != 0U) && (timeout != 0U))
     {
+        timeout--;
     }
+    return (FLEXCAN_GetFreezeMode(instance) == FLEXCAN_OUT_FREEZE_MODE) ? FLEXCAN_STATUS_SUCCESS : FLEXCAN_STATUS_TIMEOUT;
 }
 
-static void FLEXCAN_SetBitrate(uint8_t instance, flexcan_time_segment_t *timeSeg)
+/* CONFIG TRANSACTION */
+flexcan_status_t DRV_FLEXCAN_BeginConfig(uint8_t instance)
+{
+    flexcan_status_t status = FLEXCAN_STATUS_SUCCESS;
+    if (g_flexcanConfigDepth[instance] == 0U)
+    {
+        g_flexcanConfigFreeze[instance] = 0U;
+        if (FLEXCAN_GetFreezeMode(instance) == FLEXCAN_OUT_FREEZE_MODE)
+        {
+            status = FLEXCAN_EnterFreezeMode(instance);
+            if (status != FLEXCAN_STATUS_SUCCESS)
+            {
+                /* Do not leave a pending freeze request behind */
+                (void)FLEXCAN_ExitFreezeMode(instance);
+                return status;
+            }
+            g_flexcanConfigFreeze[instance] = 1U;
+        }
+    }
+    g_flexcanConfigDepth[instance]++;
+    return status;
+}
+
+flexcan_status_t DRV_FLEXCAN_CommitConfig(uint8_t instance)
+{
+    flexcan_status_t status = FLEXCAN_STATUS_SUCCESS;
+    if (g_flexcanConfigDepth[instance] == 0U)
+    {
+        return status;
+    }
+    g_flexcanConfigDepth[instance]--;
+    if ((g_flexcanConfigDepth[instance] == 0U) && (g_flexcanConfigFreeze[instance] != 0U))
+    {
+        g_flexcanConfigFreeze[instance] = 0U;
+        status = FLEXCAN_ExitFreezeMode(instance);
+    }
+    return status;
+}
+
+static flexcan_status_t FLEXCAN_SetBitrate(uint8_t instance, flexcan_time_segment_t *timeSeg)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    flexcan_status_t status = DRV_FLEXCAN_BeginConfig(instance);
+    if (status != FLEXCAN_STATUS_SUCCESS)
     {
-        FLEXCAN_EnterFreezeMode(instance);
+        return status;
     }
     base->CTRL1 = ((base->CTRL1) & ~((FLEXCAN_CTRL1_PRESDIV_MASK) | (FLEXCAN_CTRL1_PROPSEG_MASK) | (FLEXCAN_CTRL1_PSEG1_MASK) | (FLEXCAN_CTRL1_PSEG2_MASK) | (FLEXCAN_CTRL1_RJW_MASK)));
     base->CTRL1 = ((base->CTRL1) | (FLEXCAN_CTRL1_PRESDIV(timeSeg->presDiv) | FLEXCAN_CTRL1_PROPSEG(timeSeg->propSeg) | FLEXCAN_CTRL1_PSEG1(timeSeg->phaseSeg1) | FLEXCAN_CTRL1_PSEG2(timeSeg->phaseSeg2) | FLEXCAN_CTRL1_RJW(timeSeg->rJumpWidth)));
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    return DRV_FLEXCAN_CommitConfig(instance);
+}
+
+static void FLEXCAN_SetFdMode(uint8_t instance, flexcan_module_config_t *config)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_time_segment_t timeSeg;
+    uint32_t tdcOffset = 0U;
+    uint8_t maxMbIdx = 0U;
+    /* Called in freeze mode */
+    if ((config->fdEnable == 0U) || (instance != FLEXCAN_FD_INSTANCE))
     {
-        FLEXCAN_ExitFreezeMode(instance);
+        if (instance == FLEXCAN_FD_INSTANCE)
+        {
+            base->MCR = (base->MCR & ~(FLEXCAN_MCR_FDEN_MASK)) | FLEXCAN_MCR_FDEN(0U);
+            base->FDCTRL = (base->FDCTRL & ~(FLEXCAN_FDCTRL_MBDSR0_MASK | FLEXCAN_FDCTRL_FDRATE_MASK | FLEXCAN_FDCTRL_TDCEN_MASK));
+        }
+        g_flexcanMbDataWords[instance] = MESSAGE_BUFFER_SIZE - MESSAGE_BUFFER_HEADER_SIZE;
+        g_flexcanFdBrs[instance] = 0U;
+        return;
+    }
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_FDEN_MASK)) | FLEXCAN_MCR_FDEN(1U);
+    base->CTRL2 = (base->CTRL2 & ~(FLEXCAN_CTRL2_ISOCANFDEN_MASK)) | FLEXCAN_CTRL2_ISOCANFDEN(1U);
+    base->FDCTRL = FLEXCAN_FDCTRL_MBDSR0(config->payloadSize) | FLEXCAN_FDCTRL_FDRATE(config->bitrateSwitch);
+    if (config->bitrateSwitch != 0U)
+    {
+        FLEXCAN_FdBitrateToTimeSeg(config->bitrateFd, config->flexcanClkFreq, &timeSeg);
+        base->FDCBT = FLEXCAN_FDCBT_FPRESDIV(timeSeg.presDiv) | FLEXCAN_FDCBT_FPROPSEG(timeSeg.propSeg) | FLEXCAN_FDCBT_FPSEG1(timeSeg.phaseSeg1) | FLEXCAN_FDCBT_FPSEG2(timeSeg.phaseSeg2) | FLEXCAN_FDCBT_FRJW(timeSeg.rJumpWidth);
+        /* Transceiver delay compensation: secondary sample point at the data phase sample point */
+        tdcOffset = (timeSeg.propSeg + timeSeg.phaseSeg1 + 2U) * (timeSeg.presDiv + 1U);
+        if (tdcOffset > FLEXCAN_FD_TDCOFF_MAX)
+        {
+            tdcOffset = FLEXCAN_FD_TDCOFF_MAX;
+        }
+        base->FDCTRL |= FLEXCAN_FDCTRL_TDCEN(1U) | FLEXCAN_FDCTRL_TDCOFF(tdcOffset);
+    }
+    g_flexcanMbDataWords[instance] = (uint8_t)(2U << (uint32_t)config->payloadSize);
+    g_flexcanFdBrs[instance] = config->bitrateSwitch;
+    /* Larger MBs leave fewer of them in the RAM, keep MAXMB within the last one */
+    maxMbIdx = DRV_FLEXCAN_GetMbNum(instance) - 1U;
+    if (((base->MCR & FLEXCAN_MCR_MAXMB_MASK) >> FLEXCAN_MCR_MAXMB_SHIFT) > maxMbIdx)
+    {
+        base->MCR = (base->MCR & ~(FLEXCAN_MCR_MAXMB_MASK)) | FLEXCAN_MCR_MAXMB(maxMbIdx);
     }
 }
 
@@ -215,6 +406,64 @@ static uint8_t FLEXCAN_GetMaxMbNum(uint8_t instance)
     return ret;
 }
 
+uint8_t DRV_FLEXCAN_GetMbNum(uint8_t instance)
+{
+    uint8_t maxMB = FLEXCAN_GetMaxMbNum(instance);
+    uint8_t fitMB = (uint8_t)(FLEXCAN_RAMn_COUNT / (MESSAGE_BUFFER_HEADER_SIZE + g_flexcanMbDataWords[instance]));
+    return (fitMB < maxMB) ? fitMB : maxMB;
+}
+
+/* MBs are packed back to back, their size follows the payload size */
+static volatile uint32_t *FLEXCAN_GetMbAddr(uint8_t instance, uint8_t mbIdx)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t mbSize = MESSAGE_BUFFER_HEADER_SIZE + g_flexcanMbDataWords[instance];
+    return &(base->RAMn[mbIdx * mbSize]);
+}
+
+/* Smallest DLC whose payload holds length bytes */
+static uint8_t FLEXCAN_LengthToDlc(uint32_t length)
+{
+    uint8_t dlc = 0U;
+    if (length <= FLEXCAN_CLASSIC_DATA_LENGTH)
+    {
+        dlc = (uint8_t)length;
+    }
+    else
+    {
+        for (dlc = 9U; (dlc < 15U) && (g_flexcanDlcToLength[dlc] < length); dlc++)
+        {
+        }
+    }
+    return dlc;
+}
+
+static uint32_t FLEXCAN_DlcToLength(uint32_t cs)
+{
+    uint32_t dlc = (cs & FLEXCAN_MB_DLC_MASK) >> FLEXCAN_MB_DLC_SHIFT;
+    uint32_t length = g_flexcanDlcToLength[dlc];
+    /* Classic frames carry at most 8 bytes whatever the DLC */
+    if (((cs & FLEXCAN_MB_EDL_MASK) == 0U) && (length > FLEXCAN_CLASSIC_DATA_LENGTH))
+    {
+        length = FLEXCAN_CLASSIC_DATA_LENGTH;
+    }
+    return length;
+}
+
+static void FLEXCAN_ReadMbData(uint8_t instance, volatile const uint32_t *mb, flexcan_mb_t *data)
+{
+    uint8_t words = (uint8_t)((data->dataLength + 3U) / 4U);
+    uint8_t i = 0U;
+    if (words > g_flexcanMbDataWords[instance])
+    {
+        words = g_flexcanMbDataWords[instance];
+    }
+    for (i = 0U; i < words; i++)
+    {
+        data->data[i] = mb[MESSAGE_BUFFER_HEADER_SIZE + i];
+    }
+}
+
 static void FLEXCAN_ClearRAM(uint8_t instance)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
@@ -235,26 +484,31 @@ static void FLEXCAN_ClearRAM(uint8_t instance)
 
 static void FLEXCAN_InitMb(uint8_t instance)
 {
-    FLEXCAN_Type *base = g_flexcanBase[instance];
-    uint8_t maxMB = FLEXCAN_GetMaxMbNum(instance);
+    uint8_t maxMB = DRV_FLEXCAN_GetMbNum(instance);
+    uint8_t mbSize = MESSAGE_BUFFER_HEADER_SIZE + g_flexcanMbDataWords[instance];
+    volatile uint32_t *mb = NULL;
     uint8_t i = 0U;
+    uint8_t j = 0U;
     for (i = 0U; i < maxMB; i++)
     {
-        /* Mailbox = 128 words, each MB is 4 words */
-        base->RAMn[i * MESSAGE_BUFFER_SIZE + 0U] = 0x0; /* Control and Status word*/
-        base->RAMn[i * MESSAGE_BUFFER_SIZE + 1U] = 0x0; /* ID word */
-        base->RAMn[i * MESSAGE_BUFFER_SIZE + 2U] = 0x0; /* Data word 1 */
-        base->RAMn[i * MESSAGE_BUFFER_SIZE + 3U] = 0x0; /* Data word 2 */
+        /* Mailbox = 128 words, each MB is 4 words classic and up to 18 words CAN FD */
+        mb = FLEXCAN_GetMbAddr(instance, i);
+        mb[0U] = 0x0; /* Control and Status word*/
+        mb[1U] = 0x0; /* ID word */
+        for (j = MESSAGE_BUFFER_HEADER_SIZE; j < mbSize; j++)
+        {
+            mb[j] = 0x0; /* Data words */
+        }
     }
 }
 
-static void FLEXCAN_ConfigRxMaskType(uint8_t instance, flexcan_rx_mask_type_t rxMaskType)
+static flexcan_status_t FLEXCAN_ConfigRxMaskType(uint8_t instance, flexcan_rx_mask_type_t rxMaskType)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    flexcan_status_t status = DRV_FLEXCAN_BeginConfig(instance);
+    if (status != FLEXCAN_STATUS_SUCCESS)
     {
-        FLEXCAN_EnterFreezeMode(instance);
+        return status;
     }
     if (rxMaskType == FLEXCAN_RX_MASK_INDIVIDUAL)
     {
@@ -267,19 +521,17 @@ static void FLEXCAN_ConfigRxMaskType(uint8_t instance, flexcan_rx_mask_type_t rx
     else
     {
     }
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
-    {
-        FLEXCAN_ExitFreezeMode(instance);
-    }
+    return DRV_FLEXCAN_CommitConfig(instance);
 }
 
-static void FLEXCAN_SetOperationModes(uint8_t instance, flexcan_operation_modes_t flexcanMode)
+static flexcan_status_t FLEXCAN_SetOperationModes(uint8_t instance, flexcan_operation_modes_t flexcanMode)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_status_t status = FLEXCAN_STATUS_SUCCESS;
     switch (flexcanMode)
     {
     case FLEXCAN_FREEZE_MODE:
-        FLEXCAN_EnterFreezeMode(instance);
+        status = FLEXCAN_EnterFreezeMode(instance);
         break;
     case FLEXCAN_DISABLE_MODE:
         base->MCR = (base->MCR & ~(FLEXCAN_MCR_MDIS_MASK)) | FLEXCAN_MCR_MDIS(1U);
@@ -298,6 +550,7 @@ static void FLEXCAN_SetOperationModes(uint8_t instance, flexcan_operation_modes_
     default:
         break;
     }
+    return status;
 }
 
 void DRV_FLEXCAN_EnableMbInt(uint8_t instance, uint8_t mbIdx)
@@ -314,62 +567,79 @@ void DRV_FLEXCAN_DisableMbInt(uint8_t instance, uint8_t mbIdx)
     base->IMASK1 = ((base->IMASK1) & (~tmp));
 }
 
-void DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan_handle_t *handle)
+flexcan_status_t DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan_handle_t *handle)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
+    flexcan_status_t status = FLEXCAN_STATUS_SUCCESS;
     flexcan_time_segment_t timeSeg;
+    uint32_t samplePoint = 0U;
     uint8_t i = 0U;
     uint8_t flexcanMaxMBNum = FLEXCAN_GetMaxMbNum(instance);
+    /* Prepare for callback, the handle is valid even if the configuration fails */
+    for (i = 0U; i < flexcanMaxMBNum; i++)
+    {
+        handle->mbs[i] = NULL;
+        handle->mb_handler[i] = NULL;
+    }
+    handle->mb_callback = NULL;
+    handle->error_callback = NULL;
+    handle->rx_fifo_callback = NULL;
+    handle->rxFifoMask = 0U;
+    g_flexcanHandle[instance] = handle;
     /* Disable module to config clock source*/
     FLEXCAN_DisableModule(instance);
     /* Select clock source */
     FLEXCAN_SelectClockSource(instance, config->clkSrc);
     /* Enable module */
     FLEXCAN_EnableModule(instance);
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    status = DRV_FLEXCAN_BeginConfig(instance);
+    if (status != FLEXCAN_STATUS_SUCCESS)
     {
-        FLEXCAN_EnterFreezeMode(instance);
+        return status;
     }
-    FLEXCAN_ConfigRxMaskType(instance, config->rxMaskType);
+    /* Nested in the transaction: the setters below do not freeze again and cannot time out */
+    (void)FLEXCAN_ConfigRxMaskType(instance, config->rxMaskType);
     if (config->flexcanMode != FLEXCAN_LOOPBACK_MODE)
     {
         base->MCR = (base->MCR & ~(FLEXCAN_MCR_SRXDIS_MASK)) | FLEXCAN_MCR_SRXDIS(1U);
     }
-    /*Set bitrate*/
-    FLEXCAN_BitrateToTimeSeg(config->bitrate, config->flexcanClkFreq, &timeSeg);
-    FLEXCAN_SetBitrate(instance, &timeSeg);
+    /* Rx FIFO stays disabled until DRV_FLEXCAN_ConfigRxFifo */
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_RFEN_MASK)) | FLEXCAN_MCR_RFEN(0U);
+    /*Set bitrate: precomputed table first, the search only for combinations missing from it*/
+    samplePoint = (config->samplePoint != 0U) ? config->samplePoint : FLEXCAN_SAMPLE_POINT_DEFAULT;
+    if (FLEXCAN_LookupTimeSeg(config->bitrate, config->flexcanClkFreq, samplePoint, &timeSeg) == 0U)
+    {
+        FLEXCAN_BitrateToTimeSeg(config->bitrate, config->flexcanClkFreq, samplePoint, &timeSeg);
+    }
+    (void)FLEXCAN_SetBitrate(instance, &timeSeg);
+
+    /* CAN FD data phase and MB payload size, decides the MB layout */
+    FLEXCAN_SetFdMode(instance, config);
 
     /* Initialize MBs to inactive */
     FLEXCAN_ClearRAM(instance);
     FLEXCAN_InitMb(instance);
 
-    /*Set operation mode*/
-    FLEXCAN_SetOperationModes(instance, config->flexcanMode);
+    /* Tx arbitration: local priority, lowest ID or lowest buffer first, abort of pending frames */
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_LPRIOEN_MASK | FLEXCAN_MCR_AEN_MASK)) |
+                FLEXCAN_MCR_LPRIOEN(config->localPriority) | FLEXCAN_MCR_AEN(config->abortEnable);
+    base->CTRL1 = (base->CTRL1 & ~(FLEXCAN_CTRL1_LBUF_MASK)) |
+                  FLEXCAN_CTRL1_LBUF((config->txArbitration == FLEXCAN_TX_ARB_LOWEST_BUFFER) ? 1U : 0U);
 
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
-    {
-        FLEXCAN_ExitFreezeMode(instance);
-    }
+    /*Set operation mode*/
+    (void)FLEXCAN_SetOperationModes(instance, config->flexcanMode);
 
-    for (i = 0U; i < flexcanMaxMBNum; i++)
-    {
-        handle->mbs[i] = NULL;
-    }
-    /* Prepare for callback */
-    handle->mb_callback = NULL;
-    handle->bus_off_callback = NULL;
-    g_flexcanHandle[instance] = handle;
+    return DRV_FLEXCAN_CommitConfig(instance);
 }
 
 /* RECEIVE */
-void DRV_FLEXCAN_SetRxMbGlobalMask(uint8_t instance, flexcan_mb_id_type_t idType, uint32_t mask)
+flexcan_status_t DRV_FLEXCAN_SetRxMbGlobalMask(uint8_t instance, flexcan_mb_id_type_t idType, uint32_t mask)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    flexcan_status_t status = DRV_FLEXCAN_BeginConfig(instance);
+    if (status != FLEXCAN_STATUS_SUCCESS)
     {
-        FLEXCAN_EnterFreezeMode(instance);
+        return status;
     }
     if (idType == FLEXCAN_MB_ID_STD)
     {
@@ -382,19 +652,16 @@ void DRV_FLEXCAN_SetRxMbGlobalMask(uint8_t instance, flexcan_mb_id_type_t idType
     else
     {
     }
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
-    {
-        FLEXCAN_ExitFreezeMode(instance);
-    }
+    return DRV_FLEXCAN_CommitConfig(instance);
 }
 
-void DRV_FLEXCAN_SetRxMbIndividualMask(uint8_t instance, flexcan_mb_id_type_t idType, uint8_t mbIdx, uint32_t mask)
+flexcan_status_t DRV_FLEXCAN_SetRxMbIndividualMask(uint8_t instance, flexcan_mb_id_type_t idType, uint8_t mbIdx, uint32_t mask)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    flexcan_status_t status = DRV_FLEXCAN_BeginConfig(instance);
+    if (status != FLEXCAN_STATUS_SUCCESS)
     {
-        FLEXCAN_EnterFreezeMode(instance);
+        return status;
     }
     if (idType == FLEXCAN_MB_ID_STD)
     {
@@ -407,10 +674,7 @@ void DRV_FLEXCAN_SetRxMbIndividualMask(uint8_t instance, flexcan_mb_id_type_t id
     else
     {
     }
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
-    {
-        FLEXCAN_ExitFreezeMode(instance);
-    }
+    return DRV_FLEXCAN_CommitConfig(instance);
 }
 
 uint8_t DRV_FLEXCAN_GetMbIntFlag(uint8_t instance, uint8_t mbIdx)
@@ -422,92 +686,276 @@ uint8_t DRV_FLEXCAN_GetMbIntFlag(uint8_t instance, uint8_t mbIdx)
     return flag;
 }
 
+uint32_t DRV_FLEXCAN_GetMbIntFlags(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    return (base->IFLAG1 & base->IMASK1);
+}
+
 void DRV_FLEXCAN_ClearMbIntFlag(uint8_t instance, uint8_t mbIdx)
+{
+    DRV_FLEXCAN_ClearMbIntFlags(instance, (uint32_t)((uint32_t)(1U) << mbIdx));
+}
+
+void DRV_FLEXCAN_ClearMbIntFlags(uint8_t instance, uint32_t mbMask)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    base->IFLAG1 &= (uint32_t)((uint32_t)(1U) << mbIdx);
+    /* IFLAG1 is write-1-to-clear: a plain write, never a read-modify-write, so flags
+     * raised by the module in the meantime are not written back and cleared */
+    base->IFLAG1 = mbMask;
 }
 
 void DRV_FLEXCAN_ConfigRxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *rx_mb, uint32_t mb_id)
 {
-    FLEXCAN_Type *base = g_flexcanBase[instance];
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
     DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
     /* Congif IDE bit */
     if (rx_mb->idType == FLEXCAN_MB_ID_STD)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = ((uint32_t)((uint32_t)(0U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
+        mb[0U] = ((uint32_t)((uint32_t)(0U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
     }
     else if (rx_mb->idType == FLEXCAN_MB_ID_EXT)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = ((uint32_t)((uint32_t)(1U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
+        mb[0U] = ((uint32_t)((uint32_t)(1U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
     }
     else
     {
     }
     /* Config data length */
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(rx_mb->dataLength);
+    mb[0U] = (mb[0U] & ~(FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(FLEXCAN_LengthToDlc(rx_mb->dataLength));
     /* Config ID */
     if (rx_mb->idType == FLEXCAN_MB_ID_STD)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
+        mb[1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
     }
     else if (rx_mb->idType == FLEXCAN_MB_ID_EXT)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_EXT_MASK));
+        mb[1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_EXT_MASK));
     }
     else
     {
     }
     /* Write EMPTY code to active mailbox */
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_RX_EMPTY);
+    mb[0U] = (mb[0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_RX_EMPTY);
 }
 
 void DRV_FLEXCAN_Receive(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
 {
-    FLEXCAN_Type *base = g_flexcanBase[instance];
-    /* Check BUSY by checking CODE field. if EMPTY == BUSY deasserted */
-    data->cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0];
-    data->code = ((data->cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
-    while (data->code == FLEXCAN_RX_BUSY)
+    flexcan_mb_view_t view;
+    uint8_t i = 0U;
+    data->code = DRV_FLEXCAN_LockRxMb(instance, mbIdx, &view);
+    data->cs = view.cs;
+    data->msgId = view.msgId;
+    data->dataLength = view.dataLength;
+    data->timeStamp = FLEXCAN_MB_VIEW_TIMESTAMP(&view);
+    for (i = 0U; ((i * 4U) < view.dataLength) && (i < g_flexcanMbDataWords[instance]); i++)
     {
-        data->cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0];
-        data->code = ((data->cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
+        data->data[i] = FLEXCAN_MB_VIEW_WORD(&view, i);
     }
-    /*Read content of the mail box*/
-    data->msgId = ((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT);
-    data->dataLength = ((data->cs & FLEXCAN_MB_DLC_MASK) >> FLEXCAN_MB_DLC_SHIFT);
-    data->data[0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U]);
-    data->data[1U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U]);
-    /*Clear flag*/
-    DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
-    /*Read the free running timer to unlock MB*/
-    (void)base->TIMER;
+    DRV_FLEXCAN_UnlockRxMb(instance, mbIdx);
 }
 
 void DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
     flexcan_handle_t *handle = g_flexcanHandle[instance];
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
     handle->mbs[mbIdx] = data;
 
     /* Lock MB by reading it */
-    volatile uint32_t *flexcan_mb = &(base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE]);
-    (void)*flexcan_mb;
+    (void)mb[0U];
     /*Read content of the mail box*/
-    handle->mbs[mbIdx]->cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U];
-    handle->mbs[mbIdx]->msgId = ((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT);
-    handle->mbs[mbIdx]->dataLength = ((handle->mbs[mbIdx]->cs & FLEXCAN_MB_DLC_MASK) >> FLEXCAN_MB_DLC_SHIFT);
-    handle->mbs[mbIdx]->data[0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U]);
-    handle->mbs[mbIdx]->data[1U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U]);
+    handle->mbs[mbIdx]->cs = mb[0U];
+    handle->mbs[mbIdx]->msgId = ((mb[1U] & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT);
+    handle->mbs[mbIdx]->dataLength = FLEXCAN_DlcToLength(handle->mbs[mbIdx]->cs);
+    handle->mbs[mbIdx]->timeStamp = (uint16_t)(handle->mbs[mbIdx]->cs & FLEXCAN_MB_TIME_STAMP_MASK);
+    FLEXCAN_ReadMbData(instance, mb, handle->mbs[mbIdx]);
     /* Unlock MB by reading Free Running Timer*/
     (void)base->TIMER;
 }
 
-static void FLEXCAN_Mb_IRQHandler(uint8_t instance)
+/* Decode the header of a locked mailbox, the payload is left in MB RAM */
+static void FLEXCAN_MapMb(volatile const uint32_t *mb, uint32_t cs, flexcan_mb_view_t *view)
 {
+    uint32_t idWord = mb[1U];
+    view->mb = mb;
+    view->cs = cs;
+    if ((cs & FLEXCAN_MB_IDE_MASK) != 0U)
+    {
+        view->msgId = idWord & (FLEXCAN_MB_ID_STD_MASK | FLEXCAN_MB_ID_EXT_MASK);
+    }
+    else
+    {
+        view->msgId = (idWord & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT;
+    }
+    view->dataLength = FLEXCAN_DlcToLength(cs);
+}
+
+uint8_t DRV_FLEXCAN_LockRxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_view_t *view)
+{
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
+    uint32_t timeout = FLEXCAN_MB_BUSY_TIMEOUT_LOOPS;
+    /* Reading CS locks the MB. BUSY is the low bit of CODE, set on top of FULL or OVERRUN
+     * while the controller is still moving a frame in. */
+    uint32_t cs = mb[0U];
+    while (((((cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT) & FLEXCAN_RX_BUSY) != 0U) && (timeout != 0U))
+    {
+        timeout--;
+        cs = mb[0U];
+    }
+    FLEXCAN_MapMb(mb, cs, view);
+    return (uint8_t)((cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
+}
+
+void DRV_FLEXCAN_UnlockRxMb(uint8_t instance, uint8_t mbIdx)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+    /*Read the free running timer to unlock MB*/
+    (void)base->TIMER;
+}
+
+/* RX FIFO */
+static void FLEXCAN_RxFifoFilterElement(const flexcan_rx_fifo_id_filter_t *filter, uint32_t *element, uint32_t *mask)
+{
+    /* Data frames only: RTR is compared against 0 together with IDE and the ID */
+    if (filter->idType == FLEXCAN_MB_ID_EXT)
+    {
+        *element = FLEXCAN_RX_FIFO_ID_IDE_MASK | ((uint32_t)(filter->id << FLEXCAN_RX_FIFO_ID_EXT_SHIFT) & FLEXCAN_RX_FIFO_ID_EXT_MASK);
+        *mask = FLEXCAN_RX_FIFO_ID_RTR_MASK | FLEXCAN_RX_FIFO_ID_IDE_MASK | FLEXCAN_RX_FIFO_ID_EXT_MASK;
+    }
+    else
+    {
+        *element = ((uint32_t)(filter->id << FLEXCAN_RX_FIFO_ID_STD_SHIFT) & FLEXCAN_RX_FIFO_ID_STD_MASK);
+        *mask = FLEXCAN_RX_FIFO_ID_RTR_MASK | FLEXCAN_RX_FIFO_ID_IDE_MASK | FLEXCAN_RX_FIFO_ID_STD_MASK;
+    }
+}
+
+flexcan_status_t DRV_FLEXCAN_ConfigRxFifo(uint8_t instance, const flexcan_rx_fifo_config_t *config)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    flexcan_status_t status = FLEXCAN_STATUS_SUCCESS;
+    uint8_t filterNum = config->idFilterNum;
+    uint8_t rffn = 0U;
+    uint8_t i = 0U;
+    uint32_t element = 0U;
+    uint32_t mask = 0U;
+
+    /* The legacy Rx FIFO cannot be enabled together with CAN FD */
+    if ((filterNum == 0U) || (config->idFilterTable == NULL) || ((base->MCR & FLEXCAN_MCR_FDEN_MASK) != 0U))
+    {
+        return FLEXCAN_STATUS_INVALID_PARAM;
+    }
+    if (filterNum > FLEXCAN_RX_FIFO_MAX_FILTERS)
+    {
+        filterNum = FLEXCAN_RX_FIFO_MAX_FILTERS;
+    }
+    rffn = (uint8_t)((filterNum - 1U) / 8U);
+
+    status = DRV_FLEXCAN_BeginConfig(instance);
+    if (status != FLEXCAN_STATUS_SUCCESS)
+    {
+        return status;
+    }
+    /* Enable FIFO with format A filter elements */
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_RFEN_MASK | FLEXCAN_MCR_IDAM_MASK)) | FLEXCAN_MCR_RFEN(1U) | FLEXCAN_MCR_IDAM(0U);
+    base->CTRL2 = (base->CTRL2 & ~(FLEXCAN_CTRL2_RFFN_MASK)) | FLEXCAN_CTRL2_RFFN(rffn);
+    /* Table holds 8 * (RFFN + 1) elements, unused ones repeat the first element */
+    for (i = 0U; i < (8U * (rffn + 1U)); i++)
+    {
+        FLEXCAN_RxFifoFilterElement(&config->idFilterTable[(i < filterNum) ? i : 0U], &element, &mask);
+        base->RAMn[FLEXCAN_RX_FIFO_FILTER_MB * MESSAGE_BUFFER_SIZE + i] = element;
+        /* Individual masks apply with MCR[IRMQ] = 1 */
+        base->RXIMR[i] = mask;
+    }
+    /* Global FIFO mask applies with MCR[IRMQ] = 0, compare every bit */
+    base->RXFGMASK = FLEXCAN_RXFGMASK_FGM(0xFFFFFFFFU);
+    /* Drop flags left from a previous configuration */
+    base->IFLAG1 = FLEXCAN_RX_FIFO_INT_MASK;
+    handle->rxFifoMask = FLEXCAN_RX_FIFO_INT_MASK;
+    return DRV_FLEXCAN_CommitConfig(instance);
+}
+
+static void FLEXCAN_RxFifo_IRQHandler(uint8_t instance, uint32_t flags)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
     flexcan_handle_t *handle = g_flexcanHandle[instance];
+    volatile const uint32_t *output = &(base->RAMn[FLEXCAN_RX_FIFO_OUTPUT_MB * MESSAGE_BUFFER_SIZE]);
+    flexcan_mb_view_t frame;
+    uint8_t count = 0U;
+
+    if ((flags & (1UL << FLEXCAN_RX_FIFO_OVERFLOW_IDX)) != 0U)
+    {
+        base->IFLAG1 = (1UL << FLEXCAN_RX_FIFO_OVERFLOW_IDX);
+        handle->rx_fifo_callback(FLEXCAN_RX_FIFO_OVERFLOW, NULL);
+    }
+    if ((flags & (1UL << FLEXCAN_RX_FIFO_WARNING_IDX)) != 0U)
+    {
+        base->IFLAG1 = (1UL << FLEXCAN_RX_FIFO_WARNING_IDX);
+        handle->rx_fifo_callback(FLEXCAN_RX_FIFO_WARNING, NULL);
+    }
+    /* Drain in one pass, bounded by the FIFO depth so a busy bus cannot hold the ISR.
+     * Frames arriving meanwhile keep the flag set and raise the interrupt again. */
+    while (((base->IFLAG1 & (1UL << FLEXCAN_RX_FIFO_FRAME_AVAIL_IDX)) != 0U) && (count < FLEXCAN_RX_FIFO_DEPTH))
+    {
+        /* The callback decodes the frame in place at the FIFO output */
+        FLEXCAN_MapMb(output, output[0U], &frame);
+        handle->rx_fifo_callback(FLEXCAN_RX_FIFO_FRAME, &frame);
+        /* Clearing the flag releases the output and advances the FIFO */
+        base->IFLAG1 = (1UL << FLEXCAN_RX_FIFO_FRAME_AVAIL_IDX);
+        count++;
+    }
+}
+
+void DRV_FLEXCAN_RegisterRxFifoCallback(uint8_t instance, void (*cb_ptr)(flexcan_rx_fifo_event_t event, const flexcan_mb_view_t *frame))
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    handle->rx_fifo_callback = cb_ptr;
+    if (cb_ptr != NULL)
+    {
+        base->IMASK1 = ((base->IMASK1) | (FLEXCAN_RX_FIFO_INT_MASK));
+    }
+    else
+    {
+        base->IMASK1 = ((base->IMASK1) & ~(FLEXCAN_RX_FIFO_INT_MASK));
+    }
+}
+
+static void FLEXCAN_Mb_IRQHandler(uint8_t instance, uint32_t mbRange)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    /* Single read of IFLAG1 and IMASK1, the dispatch below works on this snapshot */
+    uint32_t flags = base->IFLAG1 & base->IMASK1 & mbRange;
+    uint32_t pending = flags & ~handle->rxFifoMask;
+    uint32_t unhandled = 0U;
+    uint8_t mbIdx = 0U;
+
+    if (((flags & handle->rxFifoMask) != 0U) && (handle->rx_fifo_callback != NULL))
+    {
+        FLEXCAN_RxFifo_IRQHandler(instance, flags & handle->rxFifoMask);
+    }
+
+    /* Visit only the pending mailboxes, lowest index first */
+    while (pending != 0U)
+    {
+        mbIdx = (uint8_t)__builtin_ctz(pending);
+        pending &= (pending - 1U);
+        if (handle->mb_handler[mbIdx] != NULL)
+        {
+            /* Clear before the handler so it may reuse the mailbox */
+            base->IFLAG1 = (1UL << mbIdx);
+            handle->mb_handler[mbIdx](mbIdx);
+        }
+        else
+        {
+            unhandled |= (1UL << mbIdx);
+        }
+    }
 
-    if (handle->mb_callback != NULL)
+    if ((unhandled != 0U) && (handle->mb_callback != NULL))
     {
         handle->mb_callback();
     }
@@ -516,68 +964,193 @@ static void FLEXCAN_Mb_IRQHandler(uint8_t instance)
 /* SEND */
 void DRV_FLEXCAN_ConfigTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *tx_mb, uint32_t mb_id)
 {
-    FLEXCAN_Type *base = g_flexcanBase[instance];
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
     DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
     /* Congif IDE bit */
     if (tx_mb->idType == FLEXCAN_MB_ID_STD)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = ((uint32_t)((uint32_t)(0U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
+        mb[0U] = ((uint32_t)((uint32_t)(0U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
     }
     else if (tx_mb->idType == FLEXCAN_MB_ID_EXT)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = ((uint32_t)((uint32_t)(1U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
+        mb[0U] = ((uint32_t)((uint32_t)(1U << FLEXCAN_MB_IDE_SHIFT)) & (FLEXCAN_MB_IDE_MASK));
     }
     else
     {
     }
     /* Config data length */
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(tx_mb->dataLength);
+    mb[0U] = (mb[0U] & ~(FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(FLEXCAN_LengthToDlc(tx_mb->dataLength));
     /* Config ID */
     if (tx_mb->idType == FLEXCAN_MB_ID_STD)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
+        mb[1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
     }
     else if (tx_mb->idType == FLEXCAN_MB_ID_EXT)
     {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_EXT_MASK));
+        mb[1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_EXT_MASK));
     }
     else
     {
     }
     /* Write EMPTY code to active mailbox */
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE);
+    mb[0U] = (mb[0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE);
 }
 
 void DRV_FLEXCAN_Transmit(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
 {
-    FLEXCAN_Type *base = g_flexcanBase[instance];
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
     /*Clear flag*/
     DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
     /*Prepare content of the mail box*/
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U] = data->data[0];
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U] = data->data[1];
+    mb[2U] = data->data[0];
+    mb[3U] = data->data[1];
     /* Write TX_DATA code to transmit */
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+    mb[0U] = (mb[0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+}
+
+volatile uint32_t *DRV_FLEXCAN_GetTxMbPayload(uint8_t instance, uint8_t mbIdx)
+{
+    return &(FLEXCAN_GetMbAddr(instance, mbIdx)[MESSAGE_BUFFER_HEADER_SIZE]);
+}
+
+void DRV_FLEXCAN_CommitTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_id_type_t idType, uint32_t msgId, uint32_t dataLength, uint8_t prio)
+{
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
+    uint32_t length = dataLength;
+    uint8_t dlc = 0U;
+    uint8_t words = 0U;
+    uint8_t i = 0U;
+    uint32_t cs = 0U;
+    if (length > (g_flexcanMbDataWords[instance] * 4U))
+    {
+        length = g_flexcanMbDataWords[instance] * 4U;
+    }
+    dlc = FLEXCAN_LengthToDlc(length);
+    cs = FLEXCAN_MB_DLC(dlc) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+    if (length > FLEXCAN_CLASSIC_DATA_LENGTH)
+    {
+        cs |= FLEXCAN_MB_EDL_MASK;
+        if (g_flexcanFdBrs[instance] != 0U)
+        {
+            cs |= FLEXCAN_MB_BRS_MASK;
+        }
+    }
+    /*Clear flag*/
+    DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+    /* Config ID */
+    if (idType == FLEXCAN_MB_ID_EXT)
+    {
+        mb[1U] = FLEXCAN_MB_PRIO(prio) | ((uint32_t)((uint32_t)(msgId << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK | FLEXCAN_MB_ID_EXT_MASK));
+        cs |= FLEXCAN_MB_IDE_MASK;
+    }
+    else
+    {
+        mb[1U] = FLEXCAN_MB_PRIO(prio) | ((uint32_t)((uint32_t)(msgId << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
+    }
+    /* FD padding bytes are sent as 0, the words up to length were written by the caller */
+    words = (uint8_t)((g_flexcanDlcToLength[dlc] + 3U) / 4U);
+    for (i = (uint8_t)((length + 3U) / 4U); i < words; i++)
+    {
+        mb[MESSAGE_BUFFER_HEADER_SIZE + i] = 0U;
+    }
+    /* Write DLC and TX_DATA code to transmit */
+    mb[0U] = cs;
+}
+
+void DRV_FLEXCAN_TransmitFrame(uint8_t instance, uint8_t mbIdx, flexcan_mb_id_type_t idType, flexcan_mb_t *data)
+{
+    volatile uint32_t *payload = DRV_FLEXCAN_GetTxMbPayload(instance, mbIdx);
+    uint32_t words = (data->dataLength + 3U) / 4U;
+    uint32_t i = 0U;
+    if (words > g_flexcanMbDataWords[instance])
+    {
+        words = g_flexcanMbDataWords[instance];
+    }
+    for (i = 0U; i < words; i++)
+    {
+        payload[i] = data->data[i];
+    }
+    DRV_FLEXCAN_CommitTxMb(instance, mbIdx, idType, data->msgId, data->dataLength, 0U);
+}
+
+uint8_t DRV_FLEXCAN_AbortTxMb(uint8_t instance, uint8_t mbIdx)
+{
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
+    uint32_t cs = mb[0U];
+    if (((cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT) != FLEXCAN_TX_DATA)
+    {
+        return 0U;
+    }
+    /* A frame being sent completes and turns INACTIVE, otherwise the MB stays ABORT */
+    mb[0U] = (cs & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_ABORT);
+    return 1U;
+}
+
+uint8_t DRV_FLEXCAN_IsTxMbAborted(uint8_t instance, uint8_t mbIdx)
+{
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
+    uint32_t code = (mb[0U] & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+    return (code == FLEXCAN_TX_ABORT) ? 1U : 0U;
+}
+
+uint16_t DRV_FLEXCAN_GetMbTimestamp(uint8_t instance, uint8_t mbIdx)
+{
+    volatile uint32_t *mb = FLEXCAN_GetMbAddr(instance, mbIdx);
+    return (uint16_t)(mb[0U] & FLEXCAN_MB_TIME_STAMP_MASK);
 }
 
-/*BUSOFF*/
-static void FLEXCAN_ClearBusOffIntFlag(uint8_t instance)
+uint64_t DRV_FLEXCAN_GetTimer64(uint8_t instance)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    if ((base->ESR1 & FLEXCAN_ESR1_BOFFINT_MASK) != 0U)
+    uint16_t now = (uint16_t)(base->TIMER & FLEXCAN_TIMER_TIMER_MASK);
+    /* Advance by the 16-bit distance since the last sample, at most one wrap in between */
+    g_flexcanTimer64[instance] += (uint16_t)(now - (uint16_t)g_flexcanTimer64[instance]);
+    return g_flexcanTimer64[instance];
+}
+
+uint64_t DRV_FLEXCAN_ExtendTimestamp(uint8_t instance, uint16_t timeStamp)
+{
+    uint64_t now = DRV_FLEXCAN_GetTimer64(instance);
+    return now - (uint16_t)((uint16_t)now - timeStamp);
+}
+
+/* ERROR AND BUS STATE */
+void DRV_FLEXCAN_SetBusOffRecovery(uint8_t instance, uint8_t automatic)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    /* BOFFREC set disables the automatic recovery */
+    if (automatic != 0U)
     {
-        base->ESR1 = (uint32_t)(1U << FLEXCAN_ESR1_BOFFINT_SHIFT);
+        base->CTRL1 = (base->CTRL1) & ~(FLEXCAN_CTRL1_BOFFREC_MASK);
+    }
+    else
+    {
+        base->CTRL1 = (base->CTRL1) | (FLEXCAN_CTRL1_BOFFREC_MASK);
     }
 }
 
-static void FLEXCAN_BusOff_IRQHandler(uint8_t instance)
+void DRV_FLEXCAN_GetErrorState(uint8_t instance, flexcan_error_state_t *state)
 {
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t fltConf = (base->ESR1 & FLEXCAN_ESR1_FLTCONF_MASK) >> FLEXCAN_ESR1_FLTCONF_SHIFT;
+    uint32_t ecr = base->ECR;
+    /* FLTCONF 1x: bus-off */
+    state->faultState = (fltConf >= (uint32_t)FLEXCAN_BUS_OFF) ? FLEXCAN_BUS_OFF : (flexcan_fault_state_t)fltConf;
+    state->txErrCnt = (uint8_t)((ecr & FLEXCAN_ECR_TXERRCNT_MASK) >> FLEXCAN_ECR_TXERRCNT_SHIFT);
+    state->rxErrCnt = (uint8_t)((ecr & FLEXCAN_ECR_RXERRCNT_MASK) >> FLEXCAN_ECR_RXERRCNT_SHIFT);
+}
+
+static void FLEXCAN_Error_IRQHandler(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
     flexcan_handle_t *handle = g_flexcanHandle[instance];
-    if (handle->bus_off_callback != NULL)
+    uint32_t events = base->ESR1 & FLEXCAN_ERROR_EVENT_MASK;
+    /* W1C: clear exactly the events that are reported, an event raised meanwhile stays pending */
+    base->ESR1 = events;
+    if ((handle->error_callback != NULL) && (events != 0U))
     {
-        handle->bus_off_callback();
+        handle->error_callback(events);
     }
-    FLEXCAN_ClearBusOffIntFlag(instance);
 }
 
 /* REGISTER CALL BACK FUNCTION */
@@ -587,63 +1160,71 @@ void DRV_FLEXCAN_RegisterMbCallback(uint8_t instance, void (*cb_ptr)(void))
     handle->mb_callback = cb_ptr;
 }
 
-void DRV_FLEXCAN_RegisterBusOffCallback(uint8_t instance, void (*cb_ptr)(void))
+void DRV_FLEXCAN_RegisterMbHandler(uint8_t instance, uint8_t mbIdx, void (*cb_ptr)(uint8_t mbIdx))
+{
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    handle->mb_handler[mbIdx] = cb_ptr;
+}
+
+flexcan_status_t DRV_FLEXCAN_RegisterErrorCallback(uint8_t instance, void (*cb_ptr)(uint32_t events))
 {
-    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
     FLEXCAN_Type *base = g_flexcanBase[instance];
     flexcan_handle_t *handle = g_flexcanHandle[instance];
-    handle->bus_off_callback = cb_ptr;
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    const uint32_t ctrl1Mask = FLEXCAN_CTRL1_BOFFMSK_MASK | FLEXCAN_CTRL1_TWRNMSK_MASK | FLEXCAN_CTRL1_RWRNMSK_MASK;
+    flexcan_status_t status = DRV_FLEXCAN_BeginConfig(instance);
+    if (status != FLEXCAN_STATUS_SUCCESS)
     {
-        FLEXCAN_EnterFreezeMode(instance);
+        return status;
     }
-    /* enable busoff interrupt if busoff callback function exists */
+    handle->error_callback = cb_ptr;
+    /* WRNEN and BOFFDONEMSK are only writable in freeze mode */
     if (cb_ptr != NULL)
     {
-        base->CTRL1 = (base->CTRL1) | (FLEXCAN_CTRL1_BOFFMSK_MASK);
+        base->MCR = (base->MCR) | (FLEXCAN_MCR_WRNEN_MASK);
+        base->CTRL2 = (base->CTRL2) | (FLEXCAN_CTRL2_BOFFDONEMSK_MASK);
+        base->CTRL1 = (base->CTRL1) | ctrl1Mask;
     }
     else
     {
-        base->CTRL1 = (base->CTRL1) & ~(FLEXCAN_CTRL1_BOFFMSK_MASK);
-    }
-    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
-    {
-        FLEXCAN_ExitFreezeMode(instance);
+        base->CTRL1 = (base->CTRL1) & ~ctrl1Mask;
+        base->CTRL2 = (base->CTRL2) & ~(FLEXCAN_CTRL2_BOFFDONEMSK_MASK);
+        base->MCR = (base->MCR) & ~(FLEXCAN_MCR_WRNEN_MASK);
     }
+    return DRV_FLEXCAN_CommitConfig(instance);
 }
 
 /* REAL HANDLER */
 void CAN0_ORed_0_15_MB_IRQHandler(void)
 {
-    FLEXCAN_Mb_IRQHandler(0U);
+    FLEXCAN_Mb_IRQHandler(0U, FLEXCAN_MB_0_15_MASK);
 }
 
 void CAN0_ORed_16_31_MB_IRQHandler(void)
 {
-    FLEXCAN_Mb_IRQHandler(0U);
+    FLEXCAN_Mb_IRQHandler(0U, FLEXCAN_MB_16_31_MASK);
 }
 
 void CAN0_ORed_IRQHandler(void)
 {
-    FLEXCAN_BusOff_IRQHandler(0U);
+    FLEXCAN_Error_IRQHandler(0U);
 }
 
 void CAN1_ORed_0_15_MB_IRQHandler(void)
 {
-    FLEXCAN_Mb_IRQHandler(1U);
+    FLEXCAN_Mb_IRQHandler(1U, FLEXCAN_MB_0_15_MASK);
 }
 
 void CAN1_ORed_IRQHandler(void)
 {
-    FLEXCAN_BusOff_IRQHandler(1U);
+    FLEXCAN_Error_IRQHandler(1U);
 }
 
 void CAN2_ORed_0_15_MB_IRQHandler(void)
 {
-    FLEXCAN_Mb_IRQHandler(2U);
+    FLEXCAN_Mb_IRQHandler(2U, FLEXCAN_MB_0_15_MASK);
 }
 
 void CAN2_ORed_IRQHandler(void)
 {
-    FLEXCAN_BusOff_IRQHandler(2U);
+    FLEXCAN_Error_IRQHandler(2U);
 }
@@ -0,0 +1,214 @@
+/*
+ * DRV_S32K144_FTFC.c
+ *
+ *  Created on: Oct 18, 2026
+ */
+#include <stddef.h>
+#include "DRV_S32K144_FTFC.h"
+#include "DRV_S32K144_NVIC.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define FTFC_CMD_PROGRAM_PHRASE     (0x07U)
+#define FTFC_CMD_ERASE_SECTOR       (0x09U)
+#define FTFC_CMD_PROGRAM_SECTION    (0x0BU)
+
+/* FCCOB registers are big-endian within each 32-bit group, FCCOB3 is at the lowest offset.
+ * Command parameters use the FCCOB numbers, phrase data is written raw by offset. */
+#define FTFC_FCCOB(n)               (IP_FTFC->FCCOB[((n) & ~3U) + (3U - ((n) & 3U))])
+
+#define FTFC_FSTAT_ERROR_MASK       (FTFC_FSTAT_RDCOLERR_MASK | FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK)
+
+/* Polls of FSTAT per erase slice, about 5 core cycles each: roughly 1 ms at 80 MHz */
+#define FTFC_ERASE_SLICE_POLLS      (16000U)
+#define FTFC_NO_SLICE               (0U)
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static void FTFC_LoadCommand(uint8_t command, uint32_t address);
+static ftfc_status_t FTFC_Execute(uint32_t slicePolls);
+static bool FTFC_LaunchAndWait(uint32_t slicePolls) __attribute__((section(".code_ram"), noinline));
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/* Runs from RAM: the P-Flash cannot be read until the command completes or is suspended.
+ * Launches the loaded command, or resumes a suspended erase, and waits for it. With a
+ * slice, an erase still running after slicePolls polls is suspended (ERSSUSP).
+ * Returns false when suspended. */
+static bool FTFC_LaunchAndWait(uint32_t slicePolls)
+{
+    uint32_t polls = slicePolls;
+
+    IP_FTFC->FSTAT = FTFC_FSTAT_CCIF_MASK;
+
+    while ((IP_FTFC->FSTAT & FTFC_FSTAT_CCIF_MASK) == 0U)
+    {
+        if ((slicePolls != FTFC_NO_SLICE) && (--polls == 0U))
+        {
+            IP_FTFC->FCNFG |= FTFC_FCNFG_ERSSUSP_MASK;
+            while ((IP_FTFC->FSTAT & FTFC_FSTAT_CCIF_MASK) == 0U)
+            {
+            }
+
+            /* The controller clears ERSSUSP when the erase completed before the request.
+             * A request that came after completion leaves it set: the erase is then
+             * relaunched once more, which only erases the sector again */
+            return ((IP_FTFC->FCNFG & FTFC_FCNFG_ERSSUSP_MASK) == 0U);
+        }
+    }
+
+    return true;
+}
+
+static void FTFC_LoadCommand(uint8_t command, uint32_t address)
+{
+    /* The previous command always completed, only its error flags are left */
+    IP_FTFC->FSTAT = FTFC_FSTAT_ERROR_MASK;
+
+    FTFC_FCCOB(0U) = command;
+    FTFC_FCCOB(1U) = (uint8_t)(address >> 16U);
+    FTFC_FCCOB(2U) = (uint8_t)(address >> 8U);
+    FTFC_FCCOB(3U) = (uint8_t)address;
+}
+
+static ftfc_status_t FTFC_Execute(uint32_t slicePolls)
+{
+    ftfc_status_t status = FTFC_STATUS_SUCCESS;
+    uint32_t primask = 0U;
+    uint8_t fstat = 0U;
+    bool done = false;
+
+    do
+    {
+        primask = NVIC_EnterCritical();
+        done = FTFC_LaunchAndWait(slicePolls);
+        NVIC_ExitCritical(primask);
+
+        /* Suspended: the interrupts held back during the slice run from flash here,
+         * the next launch resumes the erase */
+        if (done == false)
+        {
+            IP_FTFC->FCNFG &= (uint8_t)~FTFC_FCNFG_ERSSUSP_MASK;
+        }
+    } while (done == false);
+
+    /* The code cache may hold the erased or previous content */
+    IP_LMEM->PCCCR |= LMEM_PCCCR_INVW0_MASK | LMEM_PCCCR_INVW1_MASK | LMEM_PCCCR_GO_MASK;
+    while ((IP_LMEM->PCCCR & LMEM_PCCCR_GO_MASK) != 0U)
+    {
+    }
+
+    fstat = IP_FTFC->FSTAT;
+    if ((fstat & FTFC_FSTAT_ACCERR_MASK) != 0U)
+    {
+        status = FTFC_STATUS_ACCESS_ERROR;
+    }
+    else if ((fstat & FTFC_FSTAT_FPVIOL_MASK) != 0U)
+    {
+        status = FTFC_STATUS_PROTECTION_ERROR;
+    }
+    else if ((fstat & FTFC_FSTAT_MGSTAT0_MASK) != 0U)
+    {
+        status = FTFC_STATUS_VERIFY_ERROR;
+    }
+    else
+    {
+        /* Command completed */
+    }
+
+    return status;
+}
+
+/**
+  * @brief  Erases one P-Flash sector.
+  * @param[in]  address: sector aligned address.
+  * @retval Command result.
+  */
+ftfc_status_t DRV_FTFC_EraseSector(uint32_t address)
+{
+    if (((address % FTFC_SECTOR_SIZE) != 0U) || (address >= FTFC_PFLASH_SIZE))
+    {
+        return FTFC_STATUS_INVALID_PARAM;
+    }
+
+    FTFC_LoadCommand(FTFC_CMD_ERASE_SECTOR, address);
+
+    return FTFC_Execute(FTFC_ERASE_SLICE_POLLS);
+}
+
+/**
+  * @brief  Programs one P-Flash phrase, which must be erased.
+  * @param[in]  address: phrase aligned address.
+  * @param[in]  data: FTFC_PHRASE_SIZE bytes.
+  * @retval Command result.
+  */
+ftfc_status_t DRV_FTFC_ProgramPhrase(uint32_t address, const uint8_t *data)
+{
+    uint8_t i = 0U;
+
+    if ((data == NULL) || ((address % FTFC_PHRASE_SIZE) != 0U) || (address >= FTFC_PFLASH_SIZE))
+    {
+        return FTFC_STATUS_INVALID_PARAM;
+    }
+
+    FTFC_LoadCommand(FTFC_CMD_PROGRAM_PHRASE, address);
+
+    /* The phrase is copied raw from offset 0x08 as the NXP SDK does, data[0] in FCCOB7:
+     * flash then holds the bytes in memory order, like the Program Section buffer */
+    for (i = 0U; i < FTFC_PHRASE_SIZE; i++)
+    {
+        IP_FTFC->FCCOB[4U + i] = data[i];
+    }
+
+    return FTFC_Execute(FTFC_NO_SLICE);
+}
+
+/**
+  * @brief  Programs consecutive P-Flash phrases, which must be erased.
+  * @param[in]  address: phrase aligned address.
+  * @param[in]  data: length bytes.
+  * @param[in]  length: multiple of FTFC_PHRASE_SIZE, 8..FTFC_SECTION_MAX_SIZE.
+  * @retval Command result.
+  */
+ftfc_status_t DRV_FTFC_ProgramSection(uint32_t address, const uint8_t *data, uint16_t length)
+{
+    volatile uint8_t *sectionBuffer = (volatile uint8_t *)FEATURE_FLS_FLEX_RAM_START_ADDRESS;
+    ftfc_status_t status = FTFC_STATUS_SUCCESS;
+    uint16_t phrases = length / FTFC_PHRASE_SIZE;
+    uint16_t i = 0U;
+
+    if ((data == NULL) || ((address % FTFC_PHRASE_SIZE) != 0U) || (length == 0U) ||
+        ((length % FTFC_PHRASE_SIZE) != 0U) || (length > FTFC_SECTION_MAX_SIZE) ||
+        (address > (FTFC_PFLASH_SIZE - length)))
+    {
+        return FTFC_STATUS_INVALID_PARAM;
+    }
+
+    if ((IP_FTFC->FCNFG & FTFC_FCNFG_RAMRDY_MASK) == 0U)
+    {
+        /* FlexRAM holds emulated EEPROM, no section buffer */
+        for (i = 0U; (i < phrases) && (status == FTFC_STATUS_SUCCESS); i++)
+        {
+            status = DRV_FTFC_ProgramPhrase(address + (i * FTFC_PHRASE_SIZE), &data[i * FTFC_PHRASE_SIZE]);
+        }
+
+        return status;
+    }
+
+    for (i = 0U; i < length; i++)
+    {
+        sectionBuffer[i] = data[i];
+    }
+
+    FTFC_LoadCommand(FTFC_CMD_PROGRAM_SECTION, address);
+    FTFC_FCCOB(4U) = (uint8_t)(phrases >> 8U);
+    FTFC_FCCOB(5U) = (uint8_t)phrases;
+
+    return FTFC_Execute(FTFC_NO_SLICE);
+}
@@ -80,6 +80,16 @@ void DRV_LPIT_Init(uint8_t instance, LPIT_ChannelTypedef CHx, LPIT_InitTypedef *
         LPITx->TMR[CHx].TCTRL &= ~LPIT_TMR_TCTRL_CHAIN_MASK;
     }
 
+    /* Configure one-shot operation */
+    if(LPIT_InitStructure->LPIT_OneShot == ENABLE)
+    {
+        LPITx->TMR[CHx].TCTRL |= LPIT_TMR_TCTRL_TSOI_MASK;
+    }
+    else
+    {
+        LPITx->TMR[CHx].TCTRL &= ~LPIT_TMR_TCTRL_TSOI_MASK;
+    }
+
     /* Configure interrupt */
     if(LPIT_InitStructure->LPIT_Interupt == ENABLE)
     {
@@ -100,8 +110,8 @@ void DRV_LPIT_ClearInterruptFlagTimerChannels(uint8_t instance, LPIT_ChannelType
 {
     LPIT_Type *LPITx = g_LpitBase[instance];
 
-    /* Clear interrupt flag */
-    LPITx->MSR |= (LPIT_MSR_TIF0_MASK << CHx);
+    /* Clear interrupt flag, MSR is write-1-to-clear so only the written bit is cleared */
+    LPITx->MSR = (LPIT_MSR_TIF0_MASK << CHx);
 }
 
 /**
@@ -117,8 +127,10 @@ uint32_t DRV_LPIT_GetCurrentTimerCount(uint8_t instance, LPIT_ChannelTypedef CHx
 }
 
 /**
-  * @brief  Retrieves the current timer count value for a specified LPIT channel.
-  * @param[in]  CHx: The LPIT channel for which to clear the interrupt flag.
+  * @brief  Sets the reload value of a specified LPIT channel. On a running channel
+  *         the new value is loaded at the next timeout, the current period is not disturbed.
+  * @param[in]  CHx: The LPIT channel to configure.
+  * @param[in]  Val: number of LPIT clock cycles in one period.
   * @retval None
   */
 void DRV_LPIT_SetReloadValue(uint8_t instance, LPIT_ChannelTypedef CHx, uint32_t Val)
@@ -178,7 +190,7 @@ void DRV_LPIT0_RegisterIntCallback(LPIT_ChannelTypedef CHx, IRQ_FuncCallback fp)
 void LPIT0_Ch0_IRQHandler(void)
 {
     /* Clear interrupt flag */
-    IP_LPIT0->MSR |= (LPIT_MSR_TIF0_MASK << LPIT_CH0);
+    IP_LPIT0->MSR = (LPIT_MSR_TIF0_MASK << LPIT_CH0);
 
     LPIT_IRQ_fp[(uint8_t)(LPIT_CH0)]();
 }
@@ -191,7 +203,7 @@ void LPIT0_Ch0_IRQHandler(void)
 void LPIT0_Ch1_IRQHandler(void)
 {
     /* Clear interrupt flag */
-    IP_LPIT0->MSR |= (LPIT_MSR_TIF0_MASK << LPIT_CH1);
+    IP_LPIT0->MSR = (LPIT_MSR_TIF0_MASK << LPIT_CH1);
 
     LPIT_IRQ_fp[(uint8_t)(LPIT_CH1)]();
 }
@@ -204,7 +216,7 @@ void LPIT0_Ch1_IRQHandler(void)
 void LPIT0_Ch2_IRQHandler(void)
 {
     /* Clear interrupt flag */
-    IP_LPIT0->MSR |= (LPIT_MSR_TIF0_MASK << LPIT_CH2);
+    IP_LPIT0->MSR = (LPIT_MSR_TIF0_MASK << LPIT_CH2);
 
     LPIT_IRQ_fp[(uint8_t)(LPIT_CH2)]();
 }
@@ -217,7 +229,7 @@ void LPIT0_Ch2_IRQHandler(void)
 void LPIT0_Ch3_IRQHandler(void)
 {
     /* Clear interrupt flag */
-    IP_LPIT0->MSR |= (LPIT_MSR_TIF0_MASK << LPIT_CH3);
+    IP_LPIT0->MSR = (LPIT_MSR_TIF0_MASK << LPIT_CH3);
     
     LPIT_IRQ_fp[(uint8_t)(LPIT_CH3)]();
 }
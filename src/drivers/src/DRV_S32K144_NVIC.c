@@ -5,6 +5,7 @@
  *      Author: ndhieu131020
  */
 #include "DRV_S32K144_NVIC.h"
+#include "S32K144_features.h"
 
 /*******************************************************************************
  * Definition
@@ -118,3 +119,57 @@ uint32_t NVIC_GetPriority(IRQn_Type IRQn)
 
     return (uint32_t)retVal;
 }
+
+/**
+  * @brief  Mask all configurable interrupts and return the previous PRIMASK,
+  *         so that critical sections can be nested and used from ISRs
+  * @param  None
+  * @retval Previous PRIMASK value, to be passed to NVIC_ExitCritical
+  */
+uint32_t NVIC_EnterCritical(void)
+{
+    uint32_t primask = 0u;
+
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    __asm volatile ("cpsid i" : : : "memory");
+
+    return primask;
+}
+
+/**
+  * @brief  Restore the PRIMASK saved by NVIC_EnterCritical
+  * @param  primask: value returned by NVIC_EnterCritical
+  * @retval None
+  */
+void NVIC_ExitCritical(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/**
+  * @brief  Start an image as after a reset: every interrupt is disabled and its pending
+  *         state cleared, VTOR points to the vector table of the image, MSP is loaded from
+  *         its first entry and its reset handler runs with interrupts masked. The startup
+  *         code of the image unmasks them.
+  * @param  vectorTable: address of the vector table of the image
+  * @retval None, does not return
+  */
+void NVIC_JumpToImage(uint32_t vectorTable)
+{
+    const uint32_t *vectors = (const uint32_t *)(uintptr_t)vectorTable;
+    void (*reset)(void) = (void (*)(void))(uintptr_t)vectors[1];
+    uint8_t i = 0u;
+
+    (void)NVIC_EnterCritical();
+
+    for (i = 0u; i < NVIC_ICER_COUNT; i++)
+    {
+        NVIC->ICER[i] = 0xFFFFFFFFu;
+        NVIC->ICPR[i] = 0xFFFFFFFFu;
+    }
+
+    S32_SCB->VTOR = vectorTable;
+    __asm volatile ("msr msp, %0" : : "r" (vectors[0]) : "memory");
+
+    reset();
+}
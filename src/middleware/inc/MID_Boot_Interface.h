@@ -0,0 +1,131 @@
+/*
+ *  Filename: MID_Boot_Interface.h
+ *
+ *  Created on: 18-10-2026
+*/
+
+#ifndef MID_BOOT_INTERFACE_H_
+#define MID_BOOT_INTERFACE_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/*
+ * Firmware update over ISO-TP channel BOOT_ISOTP_CHANNEL into the application slot.
+ * The firmware at address 0 is the resident loader: MID_Boot_StartImage, first thing in
+ * main, starts the slot image after every reset if its marker is valid and its CRC-32
+ * matches, else the resident firmware runs. The slot image is the same firmware linked
+ * with S32K144_64_flash_slot.ld by the Debug_FLASH_SLOT build configuration, its vector
+ * table at BOOT_SLOT_BASE.
+ * Requests, byte 0 is the service, fields big-endian:
+ *   BOOT_SERVICE_START   bytes 1..4 image size, 5..8 CRC-32 of the image. Erases the marker,
+ *                        then the slot. Answered BOOT_ERR_RESTART by the slot image, which
+ *                        restarts into the resident firmware: repeat the START.
+ *   BOOT_SERVICE_DATA    bytes 1..2 block number, then the block. Blocks are numbered from 0
+ *                        and sent in order, all but the last are BOOT_BLOCK_SIZE long.
+ *   BOOT_SERVICE_FINISH  Checks the CRC-32 (IEEE 802.3) of the programmed image and writes
+ *                        the marker, the image starts from the next reset on.
+ *   BOOT_SERVICE_JUMP    Starts the verified image without a reset.
+ * Each request is answered with its service + BOOT_SERVICE_RESPONSE and a status,
+ * DATA also with its block number.
+ * Two requests are buffered: the master may send block N + 1 while block N is being
+ * programmed and sends block N + 2 once block N is acknowledged, so the bus and the
+ * flash work in parallel.
+ */
+#define BOOT_ISOTP_CHANNEL      (1u)
+#define BOOT_SLOT_BASE          (0x00040000u)   /* Upper half of the P-Flash, kept out of m_text */
+#define BOOT_SLOT_SIZE          (0x00040000u)
+#define BOOT_MARKER_ADDRESS     (BOOT_SLOT_BASE + BOOT_SLOT_SIZE - 0x1000u)    /* Last sector of the slot */
+#define BOOT_IMAGE_MAX_SIZE     (BOOT_MARKER_ADDRESS - BOOT_SLOT_BASE)
+#define BOOT_BLOCK_SIZE         (1024u)
+#define BOOT_SECTION_SIZE       (256u)          /* Bytes per flash command, interrupts are masked meanwhile */
+#define BOOT_VERIFY_CHUNK       (4096u)         /* Bytes checked per MID_Boot_Process call */
+
+/** @defgroup Boot service
+  * @{
+  */
+#define BOOT_SERVICE_START      (0x10u)
+#define BOOT_SERVICE_DATA       (0x11u)
+#define BOOT_SERVICE_FINISH     (0x12u)
+#define BOOT_SERVICE_JUMP       (0x13u)
+#define BOOT_SERVICE_RESPONSE   (0x40u)
+
+/** @defgroup Boot status
+  * @{
+  */
+#define BOOT_OK                 (0u)
+#define BOOT_ERR_STATE          (1u)    /* Request not expected now, e.g. DATA before START */
+#define BOOT_ERR_RANGE          (2u)    /* Image or block outside the slot                   */
+#define BOOT_ERR_SEQUENCE       (3u)    /* Block number is not the next one                 */
+#define BOOT_ERR_FLASH          (4u)    /* Erase or program command failed                   */
+#define BOOT_ERR_CRC            (5u)    /* Programmed image does not match its CRC-32        */
+#define BOOT_ERR_FORMAT         (6u)    /* Unknown service or request too short              */
+#define BOOT_ERR_RESTART        (7u)    /* Slot image restarts into the resident firmware    */
+
+/* Update progress and throughput */
+typedef struct
+{
+    uint32_t ImageSize;     /* Size announced by START                            */
+    uint32_t Programmed;    /* Image bytes programmed                             */
+    uint32_t FlashUs;       /* Time spent in erase and program commands           */
+    uint32_t TransferUs;    /* START received to image verified                   */
+    uint32_t Dropped;       /* Requests received while both buffers were full     */
+    bool     Verified;      /* Image in the slot matches its CRC-32               */
+}Boot_Status_Typedef;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief  Starts the image of the slot if its marker is valid and its CRC-32 matches.
+  *         Call first in main, before any clock or peripheral initialization.
+  *         Returns when there is no valid image or when running from the slot.
+  * @param  None
+  * @retval None
+  */
+void MID_Boot_StartImage(void);
+
+void MID_Boot_Init(void);
+
+/**
+  * @brief  Buffers a request received on BOOT_ISOTP_CHANNEL, called from the ISO-TP Rx callback
+  * @param  Data: request
+  * @param  Length: request length
+  * @retval None
+  */
+void MID_Boot_OnRequest(const uint8_t *Data, uint16_t Length);
+
+/**
+  * @brief  Releases the response buffer, called from the ISO-TP Tx done callback of
+  *         BOOT_ISOTP_CHANNEL
+  * @param  None
+  * @retval None
+  */
+void MID_Boot_OnTxDone(void);
+
+/**
+  * @brief  Executes the buffered requests, call from the main loop. Each call runs at most
+  *         one flash command or one verify chunk, so the main loop keeps running during
+  *         an update. Does not return once a JUMP was answered.
+  * @param  None
+  * @retval None
+  */
+void MID_Boot_Process(void);
+
+/**
+  * @brief  Returns the update progress. Throughput in bytes per second is
+  *         Programmed * 1000000 / TransferUs, flash bound if FlashUs is close to TransferUs.
+  * @param  status: destination
+  * @retval None
+  */
+void MID_Boot_GetStatus(Boot_Status_Typedef *status);
+
+#endif /* MID_BOOT_INTERFACE_H_ */
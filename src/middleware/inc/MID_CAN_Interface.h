@@ -11,6 +11,7 @@
 /*******************************************************************************
  * Include
  ******************************************************************************/
+#include <stdbool.h>
 
 /*******************************************************************************
  * Definition
@@ -34,6 +35,13 @@
   */
 #define TX_MSG_ROTATION_DATA_ID   0x10
 #define RX_MSG_CONFIRM_DATA_ID    0x11
+#define TX_MSG_ROTATION_BATCH_ID  0x12
+
+/** @defgroup Get current value Message ID, answered on request independently of the change rule
+  * @{
+  */
+#define RX_MSG_GET_VALUE_ID       0x13
+#define TX_MSG_VALUE_REPLY_ID     0x14
 
 /** @defgroup Stop operation Message ID
   * @{
@@ -41,56 +49,328 @@
 #define RX_MSG_STOPOPR_ID       0x40
 #define TX_CONFIRM_STOPOPR_ID   0x41
 
+/** @defgroup Time synchronization Message ID, refer to MID_TimeSync_Interface.h
+  * @{
+  */
+#define RX_MSG_TIME_SYNC_ID     0x50
+#define RX_MSG_TIME_FUP_ID      0x51
+
+/** @defgroup Sensor statistics Message ID
+  * @{
+  */
+#define RX_MSG_GET_STATS_ID     0x70
+#define TX_SENSOR_STATS_ID      0x71
+
+/** @defgroup Bus load Message ID, refer to MID_CAN_GetBusLoad
+  *           TX_BUS_LOAD_ID payload, big-endian:
+  *           bytes 0..1  own frames, 0.01 % of the bit rate over the window
+  *           bytes 2..3  received frames, 0.01 % of the bit rate over the window
+  *           bytes 4..5  highest sum of both since reset, 0.01 %
+  *           byte  6     highest Tx error counter in the window
+  *           byte  7     highest Rx error counter in the window
+  * @{
+  */
+#define RX_MSG_GET_BUS_LOAD_ID  0x72
+#define TX_BUS_LOAD_ID          0x73
+
+/** @defgroup ISO-TP channel Message ID, refer to MID_IsoTp_Interface.h.
+  *           Lowest bus priority, bulk transfers never delay other nodes' frames.
+  * @{
+  */
+#define RX_MSG_ISOTP_CH0_ID     0x7E0
+#define TX_MSG_ISOTP_CH0_ID     0x7E8
+#define RX_MSG_ISOTP_CH1_ID     0x7E1
+#define TX_MSG_ISOTP_CH1_ID     0x7E9
+
 #define RX_MSG_STOP_OPR_DATA    0x10
 #define RX_MSG_RESUME_OPR_DATA  0xFF
 
+#define RX_MSG_LOW_LATENCY_ON_DATA   0x20
+#define RX_MSG_LOW_LATENCY_OFF_DATA  0x21
+
+#define RX_MSG_BATCH_ON_DATA         0x30
+#define RX_MSG_BATCH_OFF_DATA        0x31
+
+#define RX_MSG_GET_VALUE_LATEST_DATA 0x00   /* Answer from the latest acquired sample      */
+#define RX_MSG_GET_VALUE_FRESH_DATA  0x01   /* Answer after a conversion started on request */
+
 
 #define TX_MSG_CONFIRM_CONNECTION_DATA  0xFF
 
-/** @defgroup Allocate Tx mailboxs
+/** @defgroup TX_MSG_ROTATION_DATA_ID and TX_MSG_VALUE_REPLY_ID payload
+  *           bytes 0..1  flags, TX_ROTATION_FLAG_TIME_VALID
+  *           bytes 2..3  rotation value, big-endian
+  *           bytes 4..7  global time of the sample in us, big-endian, 0 without synchronization
   * @{
   */
-#define TX_ROTATION_DATA_MB        0u
-#define TX_CONFIRM_CONNECTION_MB   1u
-#define TX_CONFIRM_STOPOPR_MB      2u
-#define TX_CONFIRM_PING_MB         3u
+#define TX_ROTATION_FLAG_TIME_VALID     (0x01000000u)
 
-/** @defgroup Allocate Rx mailboxs
+/** @defgroup Tx messages, index into the Tx message table
   * @{
   */
-#define RX_STOPOPR_MB       4u
-#define RX_CONNECTION_MB    5u
-#define RX_CONFIRM_DATA_MB  6u
-#define RX_PING_MSG_MB      7u
+#define TX_ROTATION_DATA_MSG        0u
+#define TX_CONFIRM_CONNECTION_MSG   1u
+#define TX_CONFIRM_STOPOPR_MSG      2u
+#define TX_CONFIRM_PING_MSG         3u
+#define TX_SENSOR_STATS_MSG         4u
+#define TX_ROTATION_BATCH_MSG       5u
+#define TX_VALUE_REPLY_MSG          6u
+#define TX_ISOTP_CH0_MSG            7u    /* Single, first and consecutive frames */
+#define TX_ISOTP_CH0_FC_MSG         8u    /* Flow control of received messages    */
+#define TX_ISOTP_CH1_MSG            9u
+#define TX_ISOTP_CH1_FC_MSG         10u
+#define TX_BUS_LOAD_MSG             11u
+#define TX_MSG_COUNT                12u
+
+/** @defgroup Allocate Tx mailboxs, shared by all Tx messages.
+  *           Mailboxes 0..9 hold the Rx FIFO and its 16-element ID filter table.
+  * @{
+  */
+#define TX_POOL_FIRST_MB    10u
+#define TX_POOL_MB_COUNT    4u
+
+/** @defgroup Tx message classes, lower value is served first
+  * @{
+  */
+#define CAN_TX_CLASS_REALTIME   0u    /* Rotation data and batches     */
+#define CAN_TX_CLASS_CONFIRM    1u    /* Replies to master commands    */
+#define CAN_TX_CLASS_DIAG       2u    /* Statistics and diagnostics    */
+#define CAN_TX_CLASS_BULK       3u    /* Segmented transfers           */
+#define CAN_TX_CLASS_COUNT      4u
+
+#define CAN_TX_BULK_RESERVED_MB 1u    /* Pool mailboxes bulk frames never take, kept for the classes above */
+
+#define CAN_TX_QUEUE_DEPTH      8u    /* Software queue depth per class */
 
-/** @defgroup CAN comming message state
+/** @defgroup Tx rate limits. A token bucket per message: RATE_HZ frames per second
+  *           on average, BURST frames back to back after a quiet period. A frame
+  *           without a token is held, one per message, and sent as soon as a token
+  *           is available; for a latest-value-wins message a newer value replaces
+  *           the held one, so the last value always goes out.
+  *           The node's own load is then bounded by the sum of RATE_HZ x frame bits
+  *           of the limited messages, plus the unlimited replies and transfers the
+  *           master requests. A rate of 0 leaves a message unlimited.
   * @{
   */
-#define CAN_MSG_RECEIVED      1u
-#define CAN_MSG_NO_RECEIVED   0u
+#ifndef CAN_TX_ROTATION_RATE_HZ
+#define CAN_TX_ROTATION_RATE_HZ 100u    /* Rotation data and value replies */
+#endif
+#ifndef CAN_TX_ROTATION_BURST
+#define CAN_TX_ROTATION_BURST   4u
+#endif
+#ifndef CAN_TX_DIAG_RATE_HZ
+#define CAN_TX_DIAG_RATE_HZ     10u     /* Sensor statistics and bus load on request */
+#endif
+#ifndef CAN_TX_DIAG_BURST
+#define CAN_TX_DIAG_BURST       2u
+#endif
+
+/** @defgroup Tx request result
+  * @{
+  */
+#define CAN_TX_OK             0u    /* Frame written to a mailbox or queued             */
+#define CAN_TX_REPLACED       1u    /* Queued latest-value-wins frame updated in place  */
+#define CAN_TX_QUEUE_FULL     2u    /* Frame dropped, the class queue is full           */
+#define CAN_TX_INVALID_MSG    3u    /* Tx_Msg is not a Tx message, nothing queued       */
+#define CAN_TX_THROTTLED      4u    /* Held by the rate limit, sent when a token is available */
+
+/** @defgroup Bus-off recovery policy. The first bus-off rejoins as soon as the controller
+  *           has seen 128 x 11 recessive bits, each further one within CAN_BUSOFF_STABLE_MS of
+  *           the last recovery waits twice as long as the previous one before rejoining.
+  *           A base of 0 leaves recovery entirely to the controller (BOFFREC automatic).
+  * @{
+  */
+#define CAN_BUSOFF_BACKOFF_BASE_MS    10u     /* Delay before the second consecutive rejoin */
+#define CAN_BUSOFF_BACKOFF_MAX_MS     1000u   /* Upper bound of the back-off delay          */
+#define CAN_BUSOFF_STABLE_MS          1000u   /* Bus-off free time that resets the back-off */
+
+/** @defgroup Bus state
+  * @{
+  */
+#define CAN_BUS_ERROR_ACTIVE    0u
+#define CAN_BUS_ERROR_PASSIVE   1u
+#define CAN_BUS_OFF             2u
+
+/** @defgroup Bus load window. The load is measured over the last CAN_LOAD_WINDOW_MS, slid
+  *           by one CAN_LOAD_BUCKET_MS bucket at a time.
+  * @{
+  */
+#define CAN_LOAD_BUCKET_MS      100u
+#define CAN_LOAD_BUCKET_COUNT   10u
+#define CAN_LOAD_WINDOW_MS      (CAN_LOAD_BUCKET_MS * CAN_LOAD_BUCKET_COUNT)
+
+/** @defgroup Traffic direction
+  * @{
+  */
+#define CAN_DIR_TX              0u    /* Index is the Tx message, refer to @defgroup Tx messages */
+#define CAN_DIR_RX              1u    /* Index is the element of the Rx FIFO ID filter table     */
 
 typedef struct MID_CAN_Interface
 {
     uint32_t ID;
     uint32_t Data;
+    uint32_t Data1;         /* Payload bytes 4..7 */
+    uint8_t  DataLength;    /* Payload length in bytes */
+    uint32_t TimeStamp;     /* Frame on the bus, LPIT ticks of MID_Timer_GetTimestamp */
 }Data_Typedef;
 
+/* Statistics of one Tx message class */
+typedef struct
+{
+    uint32_t Sent;          /* Frames whose transmission completed      */
+    uint32_t Dropped;       /* Frames rejected because the queue was full */
+    uint32_t Replaced;      /* Queued frames overwritten by a newer value */
+    uint32_t Aborted;       /* Pending frames withdrawn from a mailbox    */
+    uint32_t Throttled;     /* Frames held by the rate limit              */
+    uint8_t  Depth;         /* Current software queue depth             */
+    uint8_t  MaxDepth;      /* High-water mark of the queue depth       */
+    uint32_t LastLatencyUs; /* Queued to transmit complete, last frame  */
+    uint32_t MaxLatencyUs;  /* Queued to transmit complete, worst frame */
+}CAN_TxStats_Typedef;
+
+/* Statistics of the Rx FIFO */
+typedef struct
+{
+    uint32_t Received;      /* Frames read from the FIFO                  */
+    uint32_t Warnings;      /* FIFO reached 5 of 6 frames                 */
+    uint32_t Overflows;     /* Frames lost because the FIFO was full      */
+}CAN_RxStats_Typedef;
+
+/* Error supervision statistics */
+typedef struct
+{
+    uint8_t  State;         /* Bus state, refer to @defgroup Bus state      */
+    uint8_t  TxErrCnt;      /* Tx error counter                             */
+    uint8_t  RxErrCnt;      /* Rx error counter                             */
+    uint32_t Warnings;      /* Tx or Rx error counter reached 96            */
+    uint32_t ErrorPassive;  /* Warnings found the node error passive        */
+    uint32_t BusOffs;       /* Entries into bus-off                         */
+    uint32_t Recoveries;    /* Rejoins after bus-off                        */
+    uint32_t Requeued;      /* Pending frames moved back to the queues      */
+    uint32_t LastRecoveryUs;/* Bus-off to rejoin of the last recovery       */
+    uint32_t MaxRecoveryUs; /* Longest bus-off to rejoin time               */
+}CAN_ErrorStats_Typedef;
+
+/* Traffic of one ID in one direction since reset */
+typedef struct
+{
+    uint32_t ID;
+    uint32_t Frames;
+    uint32_t Bytes;         /* Payload bytes                                */
+    uint32_t BitTimes;      /* Bus time, stuff bits and intermission included */
+}CAN_IdStats_Typedef;
+
+/* Bus load over the last CAN_LOAD_WINDOW_MS, loads in 0.01 % of the bit rate.
+ * Rx counts only frames accepted by the ID filter table, the traffic of other
+ * nodes to other IDs is not seen. */
+typedef struct
+{
+    uint16_t TxLoad;        /* Frames this node sent                        */
+    uint16_t RxLoad;        /* Frames this node received                    */
+    uint16_t PeakLoad;      /* Highest TxLoad + RxLoad of any window        */
+    uint32_t TxFrames;
+    uint32_t RxFrames;
+    uint8_t  MaxTxErrCnt;   /* Highest Tx error counter sampled in the window */
+    uint8_t  MaxRxErrCnt;   /* Highest Rx error counter sampled in the window */
+}CAN_BusLoad_Typedef;
+
 /*******************************************************************************
  * API
  ******************************************************************************/
 
+/**
+  * @brief  Initializes the controller, the mailboxes and the error supervisor.
+  *         Call after MID_Timer_Init, the back-off delay uses a software timer.
+  * @param  None
+  * @retval None
+  */
 void MID_CAN_Init(void);
 
-void MID_CAN_MailboxInit(void);
+/**
+  * @brief  (Re)configures the Tx mailbox pool and the Rx FIFO inside one freeze-mode transaction.
+  *         The node is off the bus only for that single freeze cycle.
+  * @param  None
+  * @retval false if the controller did not acknowledge freeze or exit from freeze in time,
+  *         or if the Rx FIFO configuration was rejected
+  */
+bool MID_CAN_MailboxInit(void);
+
+/**
+  * @brief  Registers the handler of received commands. Frames accepted by the Rx FIFO
+  *         ID filter table are passed one at a time, in arrival order, from the CAN ISR.
+  * @param  cb_ptr: handler, Message is only valid during the call
+  * @retval None
+  */
+void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(const Data_Typedef *Message));
+
+/**
+  * @brief  Queues a Tx message with Data in payload word 0. Safe from any context.
+  * @param  Tx_Msg: Tx message, refer to @defgroup Tx messages
+  * @param  Data: payload word 0
+  * @retval Result, refer to @defgroup Tx request result
+  */
+uint8_t MID_CAN_SendCANMessage(uint8_t Tx_Msg, uint16_t Data);
+
+/**
+  * @brief  Queues both data words of a Tx message. Word 0 carries payload bytes 0..3 and
+  *         word 1 carries bytes 4..7, most significant byte first on the bus.
+  *         The frame goes to a free Tx mailbox, or waits in the queue of its class until
+  *         a transmit complete interrupt frees one. A rate-limited message without a token
+  *         is held until it has one, refer to @defgroup Tx rate limits.
+  *         Reentrant: the payload is taken by value and queue and mailbox ownership change
+  *         only inside one short critical section, so the main loop and any ISR may call it
+  *         concurrently.
+  * @param  Tx_Msg: Tx message, refer to @defgroup Tx messages
+  * @param  Data0: payload bytes 0..3
+  * @param  Data1: payload bytes 4..7
+  * @retval Result, refer to @defgroup Tx request result
+  */
+uint8_t MID_CAN_SendCANFrame(uint8_t Tx_Msg, uint32_t Data0, uint32_t Data1);
+
+/**
+  * @brief  Registers the transmit confirmation, called from the CAN ISR once per frame that
+  *         left the controller, after its mailbox was refilled from the queues
+  * @param  cb_ptr: handler, Tx_Msg is the message sent and TimeStamp the time the frame was
+  *         on the bus, in LPIT ticks of MID_Timer_GetTimestamp
+  * @retval None
+  */
+void MID_CAN_RegisterTxConfirmCallback(void (*cb_ptr)(uint8_t Tx_Msg, uint32_t TimeStamp));
+
+/**
+  * @brief  Converts a mailbox TIME_STAMP to the system time base. The 16-bit time stamp counts
+  *         CAN bit times and is resolved against the free running timer, so the frame must
+  *         be less than 65536 bit times (131 ms at 500 kbit/s) old.
+  * @param  TimeStamp: TIME_STAMP of the frame
+  * @retval Time of the frame in LPIT ticks of MID_Timer_GetTimestamp, one bit time resolution
+  */
+uint32_t MID_CAN_TimestampToSystem(uint16_t TimeStamp);
 
-void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(void));
+void MID_CAN_GetTxStats(uint8_t Tx_Class, CAN_TxStats_Typedef *stats);
 
-void MID_CAN_ReceiveMessage(uint8_t mbIdx, Data_Typedef *data);
+void MID_CAN_GetRxStats(CAN_RxStats_Typedef *stats);
 
-void MID_CAN_SendCANMessage(uint8_t Tx_Mb, uint16_t Data);
+/**
+  * @brief  Returns the error supervision statistics, State and error counters read live
+  * @param  stats: destination
+  * @retval None
+  */
+void MID_CAN_GetErrorStats(CAN_ErrorStats_Typedef *stats);
 
-void MID_ClearMessageCommingEvent(uint8_t Mailbox);
+/**
+  * @brief  Returns the bus load of the last complete window. The Rx FIFO overruns and the
+  *         Tx aborts are in CAN_RxStats_Typedef and CAN_TxStats_Typedef.
+  * @param  load: destination
+  * @retval None
+  */
+void MID_CAN_GetBusLoad(CAN_BusLoad_Typedef *load);
 
-uint8_t MID_CheckCommingMessageEvent(uint8_t Mailbox);
+/**
+  * @brief  Returns the traffic of one ID since reset
+  * @param  Direction: refer to @defgroup Traffic direction
+  * @param  Index: Tx message or Rx filter element
+  * @param  stats: destination
+  * @retval false if Index is past the last Tx message or filter element
+  */
+bool MID_CAN_GetIdStats(uint8_t Direction, uint8_t Index, CAN_IdStats_Typedef *stats);
 
 #endif /* MID_CAN_INTERFACE_H_ */
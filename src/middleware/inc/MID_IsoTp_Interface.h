@@ -0,0 +1,120 @@
+/*
+ *  Filename: MID_IsoTp_Interface.h
+ *
+ *  Created on: 18-10-2026
+*/
+
+#ifndef MID_ISOTP_INTERFACE_H_
+#define MID_ISOTP_INTERFACE_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "MID_CAN_Interface.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/*
+ * ISO 15765-2 transport over classic CAN, normal addressing, frames padded to 8 bytes.
+ * Protocol control information in byte 0, high nibble is the frame type:
+ *   SF  0x0L         L = 1..7 payload bytes follow
+ *   FF  0x1L LL      12-bit message length 8..4095, 6 payload bytes follow
+ *   CF  0x2N         N = sequence number mod 16, up to 7 payload bytes follow
+ *   FC  0x3S BS ST   S = 0 continue, 1 wait, 2 overflow; block size; STmin
+ * Each channel is a pair of IDs, refer to @defgroup ISO-TP channel Message ID: the node
+ * receives on the Rx ID and sends its own frames and the flow control of received
+ * messages on the Tx ID. A channel sends and receives one message at a time in each
+ * direction, the channels run concurrently.
+ */
+#define ISOTP_CHANNEL_COUNT     (2u)
+#define ISOTP_RX_BUFFER_SIZE    (1040u)   /* Longest message, a bootloader block and its header */
+#define ISOTP_RX_BLOCK_SIZE     (4u)      /* BS sent in flow control, 0 for a single FC. A block
+                                           * and two other commands fit the 6-frame Rx FIFO, so no
+                                           * frame of the update master is lost while a flash
+                                           * command masks the CAN ISR. Frames of other nodes can
+                                           * be, refer to DRV_S32K144_FTFC.h for the masked time */
+#define ISOTP_RX_STMIN          (0u)      /* STmin sent in flow control                        */
+#define ISOTP_TIMEOUT_MS        (1000u)   /* N_Bs and N_Cr: flow control or next CF overdue    */
+#define ISOTP_WFT_MAX           (8u)      /* Flow control WAIT accepted in a row               */
+#define ISOTP_PADDING           (0xCCu)   /* Unused bytes of a frame                           */
+
+/** @defgroup ISO-TP result
+  * @{
+  */
+#define ISOTP_OK                0u
+#define ISOTP_BUSY              1u    /* Channel is already sending, or the bulk queue is full   */
+#define ISOTP_INVALID           2u    /* Unknown channel, or length not in 1..4095               */
+#define ISOTP_TIMEOUT           3u    /* Flow control or consecutive frame overdue, or WAIT limit */
+#define ISOTP_OVERFLOW          4u    /* Receiver cannot take the message                        */
+#define ISOTP_ABORTED           5u    /* Invalid flow control, or frame lost to a full Tx queue   */
+
+/* Transfer statistics of all channels */
+typedef struct
+{
+    uint32_t Sent;          /* Messages sent completely                          */
+    uint32_t Received;      /* Messages received completely                      */
+    uint32_t TxFailed;      /* Messages not sent, refer to @defgroup ISO-TP result */
+    uint32_t RxFailed;      /* Receptions dropped on timeout, sequence or length  */
+}IsoTp_Stats_Typedef;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief  Initializes the channels. Call after MID_Timer_Init, timeouts and STmin use
+  *         a software timer.
+  * @param  None
+  * @retval None
+  */
+void MID_IsoTp_Init(void);
+
+/**
+  * @brief  Starts sending a message. Frames are queued in the bulk Tx class and each
+  *         next one from the transmit confirmation of the previous one, so the
+  *         channel keeps the bus busy as far as the receiver's flow control allows
+  *         without taking the mailboxes of real-time frames. Safe from any context.
+  * @param  Channel: 0..ISOTP_CHANNEL_COUNT - 1
+  * @param  Data: message, must stay valid until the Tx done callback
+  * @param  Length: 1..4095 bytes
+  * @retval ISOTP_OK, ISOTP_BUSY or ISOTP_INVALID
+  */
+uint8_t MID_IsoTp_Send(uint8_t Channel, const uint8_t *Data, uint16_t Length);
+
+/**
+  * @brief  Handles a frame received on an ISO-TP Rx ID, called from the CAN Rx notification
+  * @param  Message: received frame
+  * @retval None
+  */
+void MID_IsoTp_OnFrame(const Data_Typedef *Message);
+
+/**
+  * @brief  Handles a transmit confirmation, called from the CAN Tx confirm notification.
+  *         Frames of other messages are ignored.
+  * @param  Tx_Msg: Tx message sent
+  * @retval None
+  */
+void MID_IsoTp_OnTxConfirm(uint8_t Tx_Msg);
+
+/**
+  * @brief  Registers the handler of received messages, called from the CAN ISR
+  * @param  cb_ptr: handler, Data is only valid during the call
+  * @retval None
+  */
+void MID_IsoTp_RegisterRxCallback(void (*cb_ptr)(uint8_t Channel, const uint8_t *Data, uint16_t Length));
+
+/**
+  * @brief  Registers the end of transfer handler, called from an ISR once per message accepted
+  *         by MID_IsoTp_Send
+  * @param  cb_ptr: handler, Result refer to @defgroup ISO-TP result
+  * @retval None
+  */
+void MID_IsoTp_RegisterTxDoneCallback(void (*cb_ptr)(uint8_t Channel, uint8_t Result));
+
+void MID_IsoTp_GetStats(IsoTp_Stats_Typedef *stats);
+
+#endif /* MID_ISOTP_INTERFACE_H_ */
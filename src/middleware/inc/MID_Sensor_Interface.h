@@ -35,6 +35,18 @@ typedef enum
     BUSY
 }ReadFlag_Typedef;
 
+/* Conversion latency above which a result is counted as late */
+#define SENSOR_DEADLINE_US    (50U)
+
+/* Acquisition pipeline statistics */
+typedef struct
+{
+    uint32_t OverrunCount;          /* Result overwritten before the application read it */
+    uint32_t SkippedTriggerCount;   /* Trigger dropped because a conversion was still running */
+    uint32_t LateConversionCount;   /* Trigger-to-result latency exceeded SENSOR_DEADLINE_US */
+    uint32_t WorstLatencyUs;        /* Worst-case trigger-to-result latency */
+}SensorStats_Typedef;
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -52,8 +64,50 @@ void MID_Set_DataSensorState(ReadFlag_Typedef State);
 
 uint8_t MID_Get_DataSensorState(void);
 
+/**
+  * @brief  Starts a new conversion and sets the sensor state to BUSY.
+  *         A trigger that arrives while a conversion is still running is skipped,
+  *         a trigger that arrives before the last result was read counts as an overrun.
+  * @param  None
+  * @retval None
+  */
 void MID_Trigger_ReadProcess(void);
 
+/**
+  * @brief  Starts a conversion on request, outside the sampling schedule.
+  *         Counts neither as a skipped trigger nor as an overrun.
+  * @param  None
+  * @retval false if a conversion is already running, its result serves the request
+  */
+bool MID_Trigger_RequestRead(void);
+
 void MID_ADC_RegisterNotificationCallback(void (*cb_ptr)(void));
 
+/**
+  * @brief  Returns the time at which the last conversion was triggered, i.e. when the
+  *         sensor was sampled
+  * @param  None
+  * @retval LPIT ticks of MID_Timer_GetTimestamp
+  */
+uint32_t MID_Sensor_GetSampleTimestamp(void);
+
+/**
+  * @brief  Returns the last rotation value read with MID_Read_RotationValue and the time
+  *         at which it was sampled, as a consistent pair. Safe from any context.
+  * @param  Value: rotation value
+  * @param  Timestamp: LPIT ticks of MID_Timer_GetTimestamp
+  * @retval false if no value was read yet, Value and Timestamp are not written
+  */
+bool MID_Sensor_GetLatestSample(uint16_t *Value, uint32_t *Timestamp);
+
+/**
+  * @brief  Takes the sample left READY_TO_READ and sets the state to IDLE, in one step:
+  *         a sample is taken once, here or by whoever set IDLE first.
+  * @param  Value: rotation value read with MID_Read_RotationValue
+  * @retval false if no sample is ready, Value is not written
+  */
+bool MID_Sensor_TakeSample(uint16_t *Value);
+
+void MID_Sensor_GetStats(SensorStats_Typedef *stats);
+
 #endif /* MID_ADC_INTERFACE_H_ */
@@ -0,0 +1,77 @@
+/*
+ *  Filename: MID_TimeSync_Interface.h
+ *
+ *  Created on: 18-10-2026
+*/
+
+#ifndef MID_TIMESYNC_INTERFACE_H_
+#define MID_TIMESYNC_INTERFACE_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/*
+ * Two-step synchronization to the bus master clock:
+ *   SYNC       byte 0 = sequence number. Its reception time is taken from the
+ *              FlexCAN hardware time stamp.
+ *   FOLLOW_UP  bytes 0..3 = master time in us at which the SYNC was sent,
+ *              taken from the master's own transmit time stamp, big-endian.
+ * Each SYNC/FOLLOW_UP pair gives the offset of the local LPIT clock to the
+ * master clock. Successive pairs give its rate error, which is filtered and
+ * applied as a drift correction between pairs.
+ */
+#define TSYNC_FUP_TIMEOUT_MS    (50u)     /* FOLLOW_UP later than this after its SYNC is ignored   */
+#define TSYNC_TIMEOUT_MS        (5000u)   /* Synchronization lost without a valid pair this long   */
+#define TSYNC_STEP_LIMIT_US     (1000)    /* Offset error that restarts the synchronization        */
+#define TSYNC_DRIFT_FILTER      (4)       /* A new rate measurement moves the drift by 1/N         */
+
+/* Synchronization status */
+typedef struct
+{
+    bool     Synced;        /* Global time is available                          */
+    int32_t  LastOffsetUs;  /* Master minus corrected local time at the last pair */
+    int32_t  MaxOffsetUs;   /* Largest absolute offset while synchronized        */
+    int32_t  DriftPpb;      /* Rate correction applied to the local clock        */
+    uint32_t Syncs;         /* Accepted SYNC/FOLLOW_UP pairs                     */
+    uint32_t Lost;          /* SYNC without FOLLOW_UP, or missing sequence numbers */
+    uint32_t Resyncs;       /* Restarts after a timeout or an offset step        */
+}TimeSync_Status_Typedef;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief  Handles a SYNC frame. Safe from the CAN ISR.
+  * @param  Sequence: sequence number of the SYNC
+  * @param  RxTime: reception time in LPIT ticks of MID_Timer_GetTimestamp
+  * @retval None
+  */
+void MID_TimeSync_OnSync(uint8_t Sequence, uint32_t RxTime);
+
+/**
+  * @brief  Handles a FOLLOW_UP frame and corrects the local clock. Safe from the CAN ISR.
+  * @param  MasterTimeUs: master time of the preceding SYNC in us
+  * @param  RxTime: reception time in LPIT ticks of MID_Timer_GetTimestamp
+  * @retval None
+  */
+void MID_TimeSync_OnFollowUp(uint32_t MasterTimeUs, uint32_t RxTime);
+
+/**
+  * @brief  Converts a local LPIT timestamp to global time. Safe from any context.
+  * @param  LocalTime: LPIT ticks of MID_Timer_GetTimestamp
+  * @param  GlobalTimeUs: master time in us (wraps around at 2^32)
+  * @retval false if the node is not synchronized, GlobalTimeUs is not written
+  */
+bool MID_TimeSync_GetGlobalTime(uint32_t LocalTime, uint32_t *GlobalTimeUs);
+
+void MID_TimeSync_GetStatus(TimeSync_Status_Typedef *status);
+
+#endif /* MID_TIMESYNC_INTERFACE_H_ */
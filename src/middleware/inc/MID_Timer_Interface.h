@@ -11,12 +11,42 @@
 /*******************************************************************************
  * Include
  ******************************************************************************/
+#include <stdbool.h>
 
 /*******************************************************************************
  * Definition
  ******************************************************************************/
 #define LPIT_INSTANCE     0u
 
+/* Sampling period of LPIT channel 0 set by MID_Timer_Init */
+#define TIMER_SAMPLE_PERIOD_MS    100u
+
+/* LPIT channels reserved by the software timer service */
+#define SW_TIMER_DEADLINE_CH    1u    /* One-shot, programmed for the next deadline */
+#define SW_TIMER_TIMEBASE_CH    3u    /* Free-running time base                     */
+
+/** @defgroup Software timer service
+  * @{
+  */
+#define SW_TIMER_COUNT            (8U)       /* Number of virtual timers, at most 32                */
+#define SW_TIMER_TICK_US          (1000U)    /* Resolution of the virtual timers                    */
+#define SW_TIMER_WHEEL_SIZE       (32U)      /* Number of timing wheel slots, power of two          */
+#define SW_TIMER_COALESCE_TICKS   (2U)       /* Expiries this close to the earliest share a wake-up */
+#define SW_TIMER_INVALID_ID       (0xFFU)
+
+typedef enum
+{
+    SW_TIMER_ONE_SHOT,
+    SW_TIMER_PERIODIC
+} SwTimer_Mode;
+
+/* Context in which the timer callback is invoked */
+typedef enum
+{
+    SW_TIMER_CONTEXT_ISR,       /* Called from the LPIT channel 1 interrupt */
+    SW_TIMER_CONTEXT_THREAD     /* Called from MID_SwTimer_Process()        */
+} SwTimer_Context;
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -29,4 +59,79 @@ void MID_Timer_StartTimer(void);
 
 void MID_Timer_StopTimer(void);
 
+/**
+  * @brief  Changes the sampling period of LPIT channel 0 without disturbing the running period:
+  *         the new period takes effect at the next period boundary. Uses the ticks-per-us
+  *         factor computed at init, no division at runtime. The other channels are not
+  *         configurable: 1 and 3 belong to the software timer service, 2 is unused.
+  *         TIMER_SAMPLE_PERIOD_MS stays the init period, timings derived from it do not follow.
+  * @param  Period_Us: new period in microseconds
+  * @retval true if the period was accepted, false for an out-of-range period or an LPIT
+  *         clock below 1 MHz
+  */
+bool MID_Timer_SetPeriodUs(uint32_t Period_Us);
+
+/**
+  * @brief  Returns a monotonic timestamp in LPIT ticks, counted from MID_Timer_Init.
+  *         Runs on the free-running time base channel, so it keeps counting while the
+  *         sampling timer is stopped.
+  * @param  None
+  * @retval Timestamp in LPIT ticks (wraps around at 2^32)
+  */
+uint32_t MID_Timer_GetTimestamp(void);
+
+/**
+  * @brief  Converts a duration in LPIT ticks to microseconds
+  * @param  ticks: duration in LPIT ticks
+  * @retval Duration in microseconds
+  */
+uint32_t MID_Timer_TicksToUs(uint32_t ticks);
+
+/**
+  * @brief  Converts a duration in microseconds to LPIT ticks
+  * @param  us: duration in microseconds
+  * @retval Duration in LPIT ticks
+  */
+uint32_t MID_Timer_UsToTicks(uint32_t us);
+
+/**
+  * @brief  Allocates a virtual timer
+  * @param  cb_ptr: callback invoked on expiry
+  * @param  Context: context in which cb_ptr is invoked
+  * @retval Timer id, or SW_TIMER_INVALID_ID when all timers are in use
+  */
+uint8_t MID_SwTimer_Create(void (*cb_ptr)(void), SwTimer_Context Context);
+
+/**
+  * @brief  (Re)starts a virtual timer, O(1). Safe from any context.
+  * @param  TimerId: id returned by MID_SwTimer_Create
+  * @param  Timeout_Ms: delay until the first expiry, and period of a periodic timer
+  * @param  Mode: one-shot or periodic
+  * @retval None
+  */
+void MID_SwTimer_Start(uint8_t TimerId, uint32_t Timeout_Ms, SwTimer_Mode Mode);
+
+/**
+  * @brief  Stops a virtual timer and drops its pending callback, O(1). Safe from any context.
+  * @param  TimerId: id returned by MID_SwTimer_Create
+  * @retval None
+  */
+void MID_SwTimer_Stop(uint8_t TimerId);
+
+/**
+  * @brief  Runs the callbacks of expired thread-context timers. Call from the main loop.
+  * @param  None
+  * @retval None
+  */
+void MID_SwTimer_Process(void);
+
+/**
+  * @brief  Returns the number of software timer ticks since initialization.
+  *         The service is tickless: LPIT channel 1 is programmed in one-shot mode
+  *         for the next deadline only, channel 3 runs free as the time base.
+  * @param  None
+  * @retval Tick count (SW_TIMER_TICK_US each)
+  */
+uint32_t MID_SwTimer_GetTicks(void);
+
 #endif /* MID_TIMER_INTERFACE_H_ */
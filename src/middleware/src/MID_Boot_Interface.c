@@ -0,0 +1,512 @@
+/*
+ *  Filename: MID_Boot_Interface.c
+ *
+ *  Created on: 18-10-2026
+*/
+
+#include "DRV_S32K144_FTFC.h"
+#include "DRV_S32K144_NVIC.h"
+#include "system_S32K144.h"
+#include "MID_Timer_Interface.h"
+#include "MID_IsoTp_Interface.h"
+#include "MID_Boot_Interface.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define BOOT_REQUEST_COUNT      (2U)
+#define BOOT_DATA_HEADER        (3U)    /* Service and block number */
+#define BOOT_START_LENGTH       (9U)
+#define BOOT_RESPONSE_LENGTH    (4U)
+#define BOOT_ERASED_BYTE        (0xFFU)
+#define BOOT_MARKER_MAGIC       (0x544F4F42U)   /* "BOOT" in memory order */
+
+/* Request still running, no response yet */
+#define BOOT_PENDING            (0xFFU)
+
+typedef enum
+{
+    BOOT_STATE_IDLE,
+    BOOT_STATE_ERASING,     /* Marker erased, image sectors being erased */
+    BOOT_STATE_LOADING,     /* Slot erased, blocks expected */
+    BOOT_STATE_VERIFIED
+} Boot_State;
+
+/* One buffered request */
+typedef struct
+{
+    volatile bool Full;
+    uint16_t Length;
+    uint8_t  Data[BOOT_DATA_HEADER + BOOT_BLOCK_SIZE];
+} Boot_Request_Typedef;
+
+/* Validity marker at BOOT_MARKER_ADDRESS, programmed once the image matched its CRC-32 */
+typedef struct
+{
+    uint32_t Magic;
+    uint32_t ImageSize;
+    uint32_t ImageCrc;
+    uint32_t Reserved;      /* Pads the marker to whole phrases */
+} Boot_Marker_Typedef;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static uint32_t Boot_GetU32(const uint8_t *Data);
+static uint32_t Boot_Crc32(uint32_t Crc, const uint8_t *Data, uint32_t Length);
+static uint8_t Boot_Start(const Boot_Request_Typedef *req);
+static uint8_t Boot_Data(const Boot_Request_Typedef *req);
+static uint8_t Boot_Finish(void);
+static uint8_t Boot_Jump(void);
+static bool Boot_SendResponse(const Boot_Request_Typedef *req, uint8_t Status);
+static bool Boot_RunningFromSlot(void);
+static bool Boot_VectorsValid(uint32_t ImageSize);
+static bool Boot_WriteMarker(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* CRC-32 of each nibble value, reflected polynomial 0xEDB88320 */
+static const uint32_t Boot_Crc32Table[16] =
+{
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+/* Double buffer: the CAN ISR fills one while the main loop programs the other */
+static Boot_Request_Typedef Boot_Request[BOOT_REQUEST_COUNT];
+static uint8_t Boot_RxIdx = 0U;
+static uint8_t Boot_ProcessIdx = 0U;
+
+/* Progress of the request being executed, in bytes */
+static uint32_t Boot_Progress = 0U;
+static uint8_t  Boot_Result = BOOT_PENDING;
+
+static Boot_State Boot_CurrentState = BOOT_STATE_IDLE;
+static uint32_t Boot_ImageCrc = 0U;
+static uint32_t Boot_RunningCrc = 0U;
+static uint16_t Boot_NextBlock = 0U;
+static uint32_t Boot_StartTimestamp = 0U;
+
+/* Response being sent, owned by the ISO-TP channel until its Tx done */
+static uint8_t Boot_Response[BOOT_RESPONSE_LENGTH];
+static volatile bool Boot_ResponseBusy = false;
+static bool Boot_JumpPending = false;
+static bool Boot_ResetPending = false;
+
+/* Start of the vector table this firmware was linked with, refer to the linker file */
+extern uint32_t __VECTOR_TABLE[];
+
+static Boot_Status_Typedef Boot_Status;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void MID_Boot_StartImage(void)
+{
+    const Boot_Marker_Typedef *marker = (const Boot_Marker_Typedef *)FTFC_FLASH_PTR(BOOT_MARKER_ADDRESS);
+
+    if ((Boot_RunningFromSlot() == true) || (marker->Magic != BOOT_MARKER_MAGIC) ||
+        (marker->ImageSize == 0U) || (marker->ImageSize > BOOT_IMAGE_MAX_SIZE))
+    {
+        return;
+    }
+
+    /* Also catches an image damaged after its marker was written */
+    if (((Boot_Crc32(0xFFFFFFFFU, FTFC_FLASH_PTR(BOOT_SLOT_BASE), marker->ImageSize) ^ 0xFFFFFFFFU)
+         != marker->ImageCrc) || (Boot_VectorsValid(marker->ImageSize) == false))
+    {
+        return;
+    }
+
+    NVIC_JumpToImage(BOOT_SLOT_BASE);
+}
+
+void MID_Boot_Init(void)
+{
+    uint8_t i = 0U;
+
+    for (i = 0U; i < BOOT_REQUEST_COUNT; i++)
+    {
+        Boot_Request[i].Full = false;
+    }
+
+    Boot_RxIdx        = 0U;
+    Boot_ProcessIdx   = 0U;
+    Boot_Result       = BOOT_PENDING;
+    Boot_CurrentState = BOOT_STATE_IDLE;
+}
+
+static uint32_t Boot_GetU32(const uint8_t *Data)
+{
+    return ((uint32_t)Data[0] << 24U) | ((uint32_t)Data[1] << 16U) | ((uint32_t)Data[2] << 8U) | Data[3];
+}
+
+static uint32_t Boot_Crc32(uint32_t Crc, const uint8_t *Data, uint32_t Length)
+{
+    uint32_t i = 0U;
+
+    for (i = 0U; i < Length; i++)
+    {
+        Crc ^= Data[i];
+        Crc = (Crc >> 4U) ^ Boot_Crc32Table[Crc & 0x0FU];
+        Crc = (Crc >> 4U) ^ Boot_Crc32Table[Crc & 0x0FU];
+    }
+
+    return Crc;
+}
+
+void MID_Boot_OnRequest(const uint8_t *Data, uint16_t Length)
+{
+    Boot_Request_Typedef *req = &Boot_Request[Boot_RxIdx];
+    uint16_t i = 0U;
+
+    if ((Length == 0U) || (Length > sizeof(req->Data)))
+    {
+        return;
+    }
+
+    /* The master sent a block before the one two back was acknowledged */
+    if (req->Full == true)
+    {
+        Boot_Status.Dropped++;
+        return;
+    }
+
+    for (i = 0U; i < Length; i++)
+    {
+        req->Data[i] = Data[i];
+    }
+    req->Length = Length;
+    req->Full   = true;
+
+    Boot_RxIdx = (uint8_t)((Boot_RxIdx + 1U) % BOOT_REQUEST_COUNT);
+}
+
+void MID_Boot_OnTxDone(void)
+{
+    Boot_ResponseBusy = false;
+}
+
+/* Erases the marker, then the sectors the image needs, one per call */
+static uint8_t Boot_Start(const Boot_Request_Typedef *req)
+{
+    uint32_t imageSize = 0U;
+    uint32_t timestamp = 0U;
+
+    if (req->Length < BOOT_START_LENGTH)
+    {
+        return BOOT_ERR_FORMAT;
+    }
+
+    imageSize = Boot_GetU32(&req->Data[1]);
+    if ((imageSize == 0U) || (imageSize > BOOT_IMAGE_MAX_SIZE))
+    {
+        return BOOT_ERR_RANGE;
+    }
+
+    if (Boot_CurrentState != BOOT_STATE_ERASING)
+    {
+        Boot_StartTimestamp   = MID_Timer_GetTimestamp();
+        Boot_Status.ImageSize = imageSize;
+        Boot_Status.Programmed = 0U;
+        Boot_Status.FlashUs   = 0U;
+        Boot_Status.TransferUs = 0U;
+        Boot_Status.Verified  = false;
+
+        /* From here on a reset starts the resident firmware, whatever happens to the slot */
+        timestamp = MID_Timer_GetTimestamp();
+        if (DRV_FTFC_EraseSector(BOOT_MARKER_ADDRESS) != FTFC_STATUS_SUCCESS)
+        {
+            Boot_CurrentState = BOOT_STATE_IDLE;
+            return BOOT_ERR_FLASH;
+        }
+        Boot_Status.FlashUs += MID_Timer_TicksToUs(MID_Timer_GetTimestamp() - timestamp);
+
+        /* The slot image cannot erase itself: restart into the resident firmware,
+         * which answers the repeated START */
+        if (Boot_RunningFromSlot() == true)
+        {
+            Boot_CurrentState = BOOT_STATE_IDLE;
+            Boot_ResetPending = true;
+            return BOOT_ERR_RESTART;
+        }
+
+        Boot_CurrentState = BOOT_STATE_ERASING;
+        return BOOT_PENDING;
+    }
+
+    if (Boot_Progress < imageSize)
+    {
+        timestamp = MID_Timer_GetTimestamp();
+        if (DRV_FTFC_EraseSector(BOOT_SLOT_BASE + Boot_Progress) != FTFC_STATUS_SUCCESS)
+        {
+            Boot_CurrentState = BOOT_STATE_IDLE;
+            return BOOT_ERR_FLASH;
+        }
+        Boot_Status.FlashUs += MID_Timer_TicksToUs(MID_Timer_GetTimestamp() - timestamp);
+        Boot_Progress += FTFC_SECTOR_SIZE;
+
+        return BOOT_PENDING;
+    }
+
+    Boot_ImageCrc     = Boot_GetU32(&req->Data[5]);
+    Boot_NextBlock    = 0U;
+    Boot_CurrentState = BOOT_STATE_LOADING;
+
+    return BOOT_OK;
+}
+
+/* Programs a block, one section per call */
+static uint8_t Boot_Data(const Boot_Request_Typedef *req)
+{
+    uint8_t  section[BOOT_SECTION_SIZE];
+    uint16_t block  = 0U;
+    uint32_t length = 0U;
+    uint32_t offset = 0U;
+    uint32_t count  = 0U;
+    uint32_t timestamp = 0U;
+    uint32_t i = 0U;
+
+    if (Boot_CurrentState != BOOT_STATE_LOADING)
+    {
+        return BOOT_ERR_STATE;
+    }
+    if (req->Length <= BOOT_DATA_HEADER)
+    {
+        return BOOT_ERR_FORMAT;
+    }
+
+    block  = (uint16_t)(((uint16_t)req->Data[1] << 8U) | req->Data[2]);
+    length = req->Length - BOOT_DATA_HEADER;
+    offset = (uint32_t)block * BOOT_BLOCK_SIZE;
+
+    if (block != Boot_NextBlock)
+    {
+        return BOOT_ERR_SEQUENCE;
+    }
+    if (((offset + length) > Boot_Status.ImageSize) ||
+        ((length != BOOT_BLOCK_SIZE) && ((offset + length) != Boot_Status.ImageSize)))
+    {
+        return BOOT_ERR_RANGE;
+    }
+
+    count = length - Boot_Progress;
+    if (count > BOOT_SECTION_SIZE)
+    {
+        count = BOOT_SECTION_SIZE;
+    }
+
+    /* The end of the image is padded to a whole phrase with erased bytes */
+    for (i = 0U; i < BOOT_SECTION_SIZE; i++)
+    {
+        section[i] = (i < count) ? req->Data[BOOT_DATA_HEADER + Boot_Progress + i] : BOOT_ERASED_BYTE;
+    }
+
+    timestamp = MID_Timer_GetTimestamp();
+    if (DRV_FTFC_ProgramSection(BOOT_SLOT_BASE + offset + Boot_Progress, section,
+                                (uint16_t)(((count + FTFC_PHRASE_SIZE - 1U) / FTFC_PHRASE_SIZE) * FTFC_PHRASE_SIZE))
+        != FTFC_STATUS_SUCCESS)
+    {
+        Boot_CurrentState = BOOT_STATE_IDLE;
+        return BOOT_ERR_FLASH;
+    }
+    Boot_Status.FlashUs += MID_Timer_TicksToUs(MID_Timer_GetTimestamp() - timestamp);
+    Boot_Progress += count;
+
+    if (Boot_Progress < length)
+    {
+        return BOOT_PENDING;
+    }
+
+    Boot_NextBlock++;
+    Boot_Status.Programmed += length;
+
+    return BOOT_OK;
+}
+
+/* Computes the CRC-32 of the programmed image, one chunk per call */
+static uint8_t Boot_Finish(void)
+{
+    uint32_t count = Boot_Status.ImageSize - Boot_Progress;
+
+    if ((Boot_CurrentState != BOOT_STATE_LOADING) || (Boot_Status.Programmed != Boot_Status.ImageSize))
+    {
+        return BOOT_ERR_STATE;
+    }
+
+    if (Boot_Progress == 0U)
+    {
+        Boot_RunningCrc = 0xFFFFFFFFU;
+    }
+
+    if (count > BOOT_VERIFY_CHUNK)
+    {
+        count = BOOT_VERIFY_CHUNK;
+    }
+
+    Boot_RunningCrc = Boot_Crc32(Boot_RunningCrc, FTFC_FLASH_PTR(BOOT_SLOT_BASE + Boot_Progress), count);
+    Boot_Progress += count;
+
+    if (Boot_Progress < Boot_Status.ImageSize)
+    {
+        return BOOT_PENDING;
+    }
+
+    if ((Boot_RunningCrc ^ 0xFFFFFFFFU) != Boot_ImageCrc)
+    {
+        Boot_CurrentState = BOOT_STATE_IDLE;
+        return BOOT_ERR_CRC;
+    }
+
+    /* The image now starts after every reset */
+    if (Boot_WriteMarker() == false)
+    {
+        Boot_CurrentState = BOOT_STATE_IDLE;
+        return BOOT_ERR_FLASH;
+    }
+
+    Boot_CurrentState      = BOOT_STATE_VERIFIED;
+    Boot_Status.Verified   = true;
+    Boot_Status.TransferUs = MID_Timer_TicksToUs(MID_Timer_GetTimestamp() - Boot_StartTimestamp);
+
+    return BOOT_OK;
+}
+
+static bool Boot_WriteMarker(void)
+{
+    const Boot_Marker_Typedef marker = { BOOT_MARKER_MAGIC, Boot_Status.ImageSize, Boot_ImageCrc, 0xFFFFFFFFU };
+    uint32_t timestamp = MID_Timer_GetTimestamp();
+    ftfc_status_t status = DRV_FTFC_ProgramSection(BOOT_MARKER_ADDRESS, (const uint8_t *)&marker, (uint16_t)sizeof(marker));
+
+    Boot_Status.FlashUs += MID_Timer_TicksToUs(MID_Timer_GetTimestamp() - timestamp);
+
+    return (status == FTFC_STATUS_SUCCESS);
+}
+
+/* The firmware linked for the slot runs from it, refer to S32K144_64_flash_slot.ld */
+static bool Boot_RunningFromSlot(void)
+{
+    return ((uint32_t)(uintptr_t)__VECTOR_TABLE == BOOT_SLOT_BASE);
+}
+
+/* The reset vector must point into the image */
+static bool Boot_VectorsValid(uint32_t ImageSize)
+{
+    const uint32_t *vectors = (const uint32_t *)FTFC_FLASH_PTR(BOOT_SLOT_BASE);
+
+    return ((vectors[1] >= BOOT_SLOT_BASE) && (vectors[1] < (BOOT_SLOT_BASE + ImageSize)));
+}
+
+static uint8_t Boot_Jump(void)
+{
+    if (Boot_CurrentState != BOOT_STATE_VERIFIED)
+    {
+        return BOOT_ERR_STATE;
+    }
+
+    if (Boot_VectorsValid(Boot_Status.ImageSize) == false)
+    {
+        return BOOT_ERR_RANGE;
+    }
+
+    Boot_JumpPending = true;
+
+    return BOOT_OK;
+}
+
+static bool Boot_SendResponse(const Boot_Request_Typedef *req, uint8_t Status)
+{
+    uint16_t length = 2U;
+
+    if (Boot_ResponseBusy == true)
+    {
+        return false;
+    }
+
+    Boot_Response[0] = (uint8_t)(req->Data[0] + BOOT_SERVICE_RESPONSE);
+    Boot_Response[1] = Status;
+    if ((req->Data[0] == BOOT_SERVICE_DATA) && (req->Length > 2U))
+    {
+        Boot_Response[2] = req->Data[1];
+        Boot_Response[3] = req->Data[2];
+        length = BOOT_RESPONSE_LENGTH;
+    }
+
+    Boot_ResponseBusy = true;
+    if (MID_IsoTp_Send(BOOT_ISOTP_CHANNEL, Boot_Response, length) != ISOTP_OK)
+    {
+        Boot_ResponseBusy = false;
+        return false;
+    }
+
+    return true;
+}
+
+void MID_Boot_Process(void)
+{
+    Boot_Request_Typedef *req = &Boot_Request[Boot_ProcessIdx];
+
+    if ((Boot_JumpPending == true) && (Boot_ResponseBusy == false))
+    {
+        NVIC_JumpToImage(BOOT_SLOT_BASE);
+    }
+
+    if ((Boot_ResetPending == true) && (Boot_ResponseBusy == false))
+    {
+        SystemSoftwareReset();
+    }
+
+    if (req->Full == false)
+    {
+        return;
+    }
+
+    if (Boot_Result == BOOT_PENDING)
+    {
+        switch (req->Data[0])
+        {
+            case BOOT_SERVICE_START:
+                Boot_Result = Boot_Start(req);
+                break;
+
+            case BOOT_SERVICE_DATA:
+                Boot_Result = Boot_Data(req);
+                break;
+
+            case BOOT_SERVICE_FINISH:
+                Boot_Result = Boot_Finish();
+                break;
+
+            case BOOT_SERVICE_JUMP:
+                Boot_Result = Boot_Jump();
+                break;
+
+            default:
+                Boot_Result = BOOT_ERR_FORMAT;
+                break;
+        }
+    }
+
+    /* Done: answer, then hand the buffer back to the CAN ISR */
+    if ((Boot_Result != BOOT_PENDING) && (Boot_SendResponse(req, Boot_Result) == true))
+    {
+        Boot_Result   = BOOT_PENDING;
+        Boot_Progress = 0U;
+        req->Full     = false;
+        Boot_ProcessIdx = (uint8_t)((Boot_ProcessIdx + 1U) % BOOT_REQUEST_COUNT);
+    }
+}
+
+void MID_Boot_GetStatus(Boot_Status_Typedef *status)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    *status = Boot_Status;
+
+    NVIC_ExitCritical(primask);
+}
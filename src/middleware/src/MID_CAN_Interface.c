@@ -9,7 +9,9 @@
 #include "DRV_S32K144_PORT.h"
 #include "DRV_S32K144_FLEXCAN.h"
 #include "DRV_S32K144_MCU.h"
+#include "DRV_S32K144_NVIC.h"
 #include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
 
 /*******************************************************************************
  * Definition
@@ -17,33 +19,203 @@
 
 #define FLEXCAN_BITRATE               (500000u)
 #define FLEXCAN_DATA_LENGTH           (8U)             /* Message buffer data length (8 bytes) */
-#define FLEXCAN_GLOBAL_MASK           (0x1FFFFFFF)     /* Global mask (29-bit mask) */
-#define FLEXCAN_INDIVIDUAL_MASK       (0xFFFFFFFF)     /* Individual mask (all bits set) */
+#define FLEXCAN_BIT_TIME_US           (1000000u / FLEXCAN_BITRATE)    /* Whole microseconds up to 1 Mbit/s */
+
+#define TX_POOL_MB_MASK    (((1UL << TX_POOL_MB_COUNT) - 1UL) << TX_POOL_FIRST_MB)
+
+#define CAN_SUPERVISOR_PERIOD_MS      (10u)    /* Error state polling and back-off resolution */
+#define CAN_BUSOFF_BACKOFF_MAX_SHIFT  (16u)
+
+#define CAN_TX_TOKEN                  (1000000u)    /* Token bucket unit: one token per second is 1 unit per us */
+
+#define CAN_LOAD_BUCKET_TICKS         (CAN_LOAD_BUCKET_MS / CAN_SUPERVISOR_PERIOD_MS)
+#define CAN_LOAD_WINDOW_BITS          (((uint64_t)FLEXCAN_BITRATE * CAN_LOAD_WINDOW_MS) / 1000u)
+
+/* Classic base frame: SOF, ID, RTR, IDE, r0, DLC, data and CRC are subject to bit stuffing,
+ * CRC delimiter, ACK slot, ACK delimiter, EOF and intermission are not */
+#define CAN_FRAME_STUFFED_BITS(len)   (34u + (8u * (len)))
+#define CAN_FRAME_TRAILER_BITS        (13u)
+#define CAN_CRC15_POLY                (0x4599u)
+
+/* Static description of a Tx message */
+typedef struct
+{
+    uint32_t ID;
+    uint8_t  Class;
+    uint8_t  DataLength;
+    bool     LatestWins;    /* A newer value replaces a queued one instead of queuing behind it */
+    uint16_t RateHz;        /* Token rate, 0 for no limit, refer to @defgroup Tx rate limits */
+    uint8_t  Burst;         /* Token bucket size, at least 1 when limited */
+} CAN_TxMessage_Typedef;
+
+/* Queued frame */
+typedef struct
+{
+    uint8_t  Msg;
+    uint32_t Data[2];
+    uint32_t QueuedAt;      /* LPIT timestamp of the value, for the queue-to-wire latency */
+} CAN_TxEntry_Typedef;
+
+/* Ring buffer of one Tx class */
+typedef struct
+{
+    CAN_TxEntry_Typedef Entries[CAN_TX_QUEUE_DEPTH];
+    uint8_t Head;
+    uint8_t Count;
+} CAN_TxQueue_Typedef;
+
+/* Rate limit state of one Tx message */
+typedef struct
+{
+    uint32_t Tokens;        /* In CAN_TX_TOKEN units */
+    uint32_t RefilledAt;    /* LPIT timestamp of the last refill */
+} CAN_TxBucket_Typedef;
+
+/* Traffic of one CAN_LOAD_BUCKET_MS slice of the load window */
+typedef struct
+{
+    uint32_t TxBits;
+    uint32_t RxBits;
+    uint16_t TxFrames;
+    uint16_t RxFrames;
+    uint8_t  MaxTxErrCnt;
+    uint8_t  MaxRxErrCnt;
+} CAN_LoadBucket_Typedef;
+
+/* Bit stream of a frame being sized, level and run length of the last bit on the bus */
+typedef struct
+{
+    uint16_t Crc;
+    uint8_t  Level;
+    uint8_t  Run;
+    uint8_t  Stuff;
+} CAN_BitStream_Typedef;
 
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 
 static void FLEXCAN_Pin_Init(void);
-static void FLEXCAN_ParamConfig(void);
+static bool FLEXCAN_ParamConfig(void);
 static void FLEXCAN_Tx_Mb_Init(void);
-static void FLEXCAN_Rx_Mb_Init(void);
+static bool FLEXCAN_Rx_Fifo_Init(void);
+static void CAN_RxFifoNotification(flexcan_rx_fifo_event_t event, const flexcan_mb_view_t *frame);
+static void CAN_TxFill(uint8_t mbIdx, const CAN_TxEntry_Typedef *entry);
+static void CAN_TxKick(void);
+static void CAN_TxCompleteNotification(uint8_t mbIdx);
+static void CAN_TxRequeue(const CAN_TxEntry_Typedef *entry);
+static void CAN_TxAbortStale(uint8_t Tx_Msg);
+static uint8_t CAN_TxEnqueue(uint8_t Tx_Msg, uint32_t Data0, uint32_t Data1, uint32_t QueuedAt);
+static void CAN_TxRefill(uint8_t Tx_Msg, uint32_t now);
+static uint8_t CAN_TxHold(uint8_t Tx_Msg, uint32_t Data0, uint32_t Data1, uint32_t QueuedAt);
+static void CAN_TxRelease(uint8_t Tx_Msg);
+static void CAN_TxLimiter_Init(void);
+static void CAN_Supervisor_Init(void);
+static void CAN_SupervisorTick(void);
+static void CAN_ErrorNotification(uint32_t events);
+static void CAN_BusOffEnter(void);
+static void CAN_BusOffExit(void);
+static void CAN_FeedBits(CAN_BitStream_Typedef *stream, uint32_t value, uint8_t count, bool crc);
+static uint32_t CAN_FrameBits(uint32_t id, uint8_t len, uint32_t data0, uint32_t data1);
+static void CAN_LoadRecord(CAN_IdStats_Typedef *idStats, uint8_t direction, uint8_t len, uint32_t bits);
+static void CAN_LoadTick(const flexcan_error_state_t *errState);
+static void CAN_LoadWindow(CAN_BusLoad_Typedef *load);
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 static flexcan_handle_t handle;
 
-static flexcan_mb_t Transmit_Message;
+static const CAN_TxMessage_Typedef CAN_TxMessageTable[TX_MSG_COUNT] =
+{
+    [TX_ROTATION_DATA_MSG]      = { TX_MSG_ROTATION_DATA_ID,      CAN_TX_CLASS_REALTIME, FLEXCAN_DATA_LENGTH, true,  CAN_TX_ROTATION_RATE_HZ, CAN_TX_ROTATION_BURST },
+    [TX_CONFIRM_CONNECTION_MSG] = { TX_MSG_CONFIRM_CONNECTION_ID, CAN_TX_CLASS_CONFIRM,  4U,                  false, 0U,                      0U                    },
+    [TX_CONFIRM_STOPOPR_MSG]    = { TX_CONFIRM_STOPOPR_ID,        CAN_TX_CLASS_CONFIRM,  4U,                  false, 0U,                      0U                    },
+    [TX_CONFIRM_PING_MSG]       = { TX_CONFIRM_PING_ID,           CAN_TX_CLASS_CONFIRM,  4U,                  false, 0U,                      0U                    },
+    [TX_SENSOR_STATS_MSG]       = { TX_SENSOR_STATS_ID,           CAN_TX_CLASS_DIAG,     FLEXCAN_DATA_LENGTH, true,  CAN_TX_DIAG_RATE_HZ,     CAN_TX_DIAG_BURST     },
+    /* Bounded by the batch flush rules, a batch cannot be coalesced */
+    [TX_ROTATION_BATCH_MSG]     = { TX_MSG_ROTATION_BATCH_ID,     CAN_TX_CLASS_REALTIME, FLEXCAN_DATA_LENGTH, false, 0U,                      0U                    },
+    [TX_VALUE_REPLY_MSG]        = { TX_MSG_VALUE_REPLY_ID,        CAN_TX_CLASS_REALTIME, FLEXCAN_DATA_LENGTH, true,  CAN_TX_ROTATION_RATE_HZ, CAN_TX_ROTATION_BURST },
+    /* Paced by the receiver's flow control */
+    [TX_ISOTP_CH0_MSG]          = { TX_MSG_ISOTP_CH0_ID,          CAN_TX_CLASS_BULK,     FLEXCAN_DATA_LENGTH, false, 0U,                      0U                    },
+    [TX_ISOTP_CH0_FC_MSG]       = { TX_MSG_ISOTP_CH0_ID,          CAN_TX_CLASS_BULK,     FLEXCAN_DATA_LENGTH, false, 0U,                      0U                    },
+    [TX_ISOTP_CH1_MSG]          = { TX_MSG_ISOTP_CH1_ID,          CAN_TX_CLASS_BULK,     FLEXCAN_DATA_LENGTH, false, 0U,                      0U                    },
+    [TX_ISOTP_CH1_FC_MSG]       = { TX_MSG_ISOTP_CH1_ID,          CAN_TX_CLASS_BULK,     FLEXCAN_DATA_LENGTH, false, 0U,                      0U                    },
+    [TX_BUS_LOAD_MSG]           = { TX_BUS_LOAD_ID,               CAN_TX_CLASS_DIAG,     FLEXCAN_DATA_LENGTH, true,  CAN_TX_DIAG_RATE_HZ,     CAN_TX_DIAG_BURST     }
+};
+
+static CAN_TxQueue_Typedef CAN_TxQueue[CAN_TX_CLASS_COUNT];
+
+static CAN_TxStats_Typedef CAN_TxStats[CAN_TX_CLASS_COUNT];
+
+static CAN_TxBucket_Typedef CAN_TxBuckets[TX_MSG_COUNT];
 
-static flexcan_mb_t Receive_Message;
+/* Frame held by the rate limit, one per message, valid while its bit is set in CAN_TxHeldMask */
+static CAN_TxEntry_Typedef CAN_TxHeld[TX_MSG_COUNT];
+static uint32_t CAN_TxHeldMask = 0U;
 
-flexcan_mb_config_t mbCfg =
+/* Pool mailboxes holding a pending frame, one bit per mailbox index */
+static uint32_t CAN_TxBusyMask = 0U;
+
+/* Frame pending in each mailbox, kept to requeue it when its transmission is aborted */
+static CAN_TxEntry_Typedef CAN_TxMbEntry[FLEXCAN_MAX_MB_NUM];
+
+/* Command IDs accepted by the Rx FIFO */
+static const flexcan_rx_fifo_id_filter_t CAN_RxFilterTable[] =
+{
+    { FLEXCAN_MB_ID_STD, RX_MSG_STOPOPR_ID      },
+    { FLEXCAN_MB_ID_STD, RX_MSG_CONNECTION_ID   },
+    { FLEXCAN_MB_ID_STD, RX_MSG_CONFIRM_DATA_ID },
+    { FLEXCAN_MB_ID_STD, RX_PING_MSG_ID         },
+    { FLEXCAN_MB_ID_STD, RX_MSG_GET_STATS_ID    },
+    { FLEXCAN_MB_ID_STD, RX_MSG_GET_BUS_LOAD_ID },
+    { FLEXCAN_MB_ID_STD, RX_MSG_TIME_SYNC_ID    },
+    { FLEXCAN_MB_ID_STD, RX_MSG_TIME_FUP_ID     },
+    { FLEXCAN_MB_ID_STD, RX_MSG_GET_VALUE_ID    },
+    { FLEXCAN_MB_ID_STD, RX_MSG_ISOTP_CH0_ID    },
+    { FLEXCAN_MB_ID_STD, RX_MSG_ISOTP_CH1_ID    }
+};
+
+#define CAN_RX_FILTER_NUM    (sizeof(CAN_RxFilterTable) / sizeof(CAN_RxFilterTable[0]))
+
+static CAN_RxStats_Typedef CAN_RxStats;
+
+/* Traffic per Tx message and per Rx filter element, the ID is filled in on read */
+static CAN_IdStats_Typedef CAN_TxIdStats[TX_MSG_COUNT];
+static CAN_IdStats_Typedef CAN_RxIdStats[CAN_RX_FILTER_NUM];
+
+/* Ring of load buckets: the one being filled and the CAN_LOAD_BUCKET_COUNT of the last window */
+static CAN_LoadBucket_Typedef CAN_LoadBuckets[CAN_LOAD_BUCKET_COUNT + 1U];
+static uint8_t  CAN_LoadBucketIdx = 0U;
+static uint8_t  CAN_LoadBucketTicks = 0U;
+static uint16_t CAN_PeakLoad = 0U;
+
+static void (*CAN_RxUserCallback)(const Data_Typedef *Message) = NULL;
+
+static void (*CAN_TxConfirmCallback)(uint8_t Tx_Msg, uint32_t TimeStamp) = NULL;
+
+static CAN_ErrorStats_Typedef CAN_ErrorStats;
+
+/* Bus state tracked by the supervisor, refer to @defgroup Bus state */
+static uint8_t CAN_BusState = CAN_BUS_ERROR_ACTIVE;
+
+/* Consecutive bus-offs, each one doubles the back-off delay */
+static uint8_t CAN_BusOffBurst = 0U;
+
+/* Remaining back-off before the controller may rejoin, 0 when not waiting */
+static uint32_t CAN_BackoffMs = 0U;
+
+/* LPIT timestamps of the last bus-off entry and the last recovery */
+static uint32_t CAN_BusOffTimestamp = 0U;
+static uint32_t CAN_RecoveryTimestamp = 0U;
+
+static flexcan_mb_config_t mbCfg =
 {
     .idType = FLEXCAN_MB_ID_STD,
     .dataLength = 4U
 };
 
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -62,7 +234,7 @@ static void FLEXCAN_Pin_Init(void)
     DRV_PORT_Init(GET_PORT((uint8_t)Flexcan_Rx_Pin), GET_PIN_NUM((uint8_t)Flexcan_Rx_Pin), &PortConfigCAN);
 }
 
-static void FLEXCAN_ParamConfig(void)
+static bool FLEXCAN_ParamConfig(void)
 {
     uint32_t CAN_ClkFreq = 0u;
 
@@ -72,7 +244,12 @@ static void FLEXCAN_ParamConfig(void)
         .flexcanClkFreq = CAN_ClkFreq,
         .bitrate = FLEXCAN_BITRATE,
         .rxMaskType = FLEXCAN_RX_MASK_INDIVIDUAL,
-        .flexcanMode = FLEXCAN_NORMAL_MODE
+        .flexcanMode = FLEXCAN_NORMAL_MODE,
+        .fdEnable = 0U,     /* Classic CAN: commands are received through the legacy Rx FIFO */
+        /* Pending frames are ranked by class first (PRIO), then by ID, and can be aborted */
+        .txArbitration = FLEXCAN_TX_ARB_LOWEST_ID,
+        .localPriority = 1U,
+        .abortEnable = 1U
     };
 
     if(moduleCfg.clkSrc == FLEXCAN_CLK_SRC_PERIPH)
@@ -89,82 +266,895 @@ static void FLEXCAN_ParamConfig(void)
         moduleCfg.flexcanClkFreq = CAN_ClkFreq;
     }
 
-    DRV_FLEXCAN_Init(FLEXCAN_INSTANCE, &moduleCfg, &handle);
+    return (DRV_FLEXCAN_Init(FLEXCAN_INSTANCE, &moduleCfg, &handle) == FLEXCAN_STATUS_SUCCESS);
 }
 
 static void FLEXCAN_Tx_Mb_Init(void)
 {
-    /* Initialize Tx Message buffer to send sensor data to CAN Bus */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_ROTATION_DATA_MB, &mbCfg, TX_MSG_ROTATION_DATA_ID);
+    uint8_t mbIdx = 0U;
 
-    /* Initialize Tx Message buffer to send confirm initialize connection from Forwarder to CAN Bus */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_CONFIRM_CONNECTION_MB, &mbCfg, TX_MSG_CONFIRM_CONNECTION_ID);
-
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_CONFIRM_STOPOPR_MB, &mbCfg, TX_CONFIRM_STOPOPR_ID);
+    /* Initialize the Tx mailbox pool, the ID and DLC are written per frame */
+    for (mbIdx = TX_POOL_FIRST_MB; mbIdx < (TX_POOL_FIRST_MB + TX_POOL_MB_COUNT); mbIdx++)
+    {
+        DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, mbIdx, &mbCfg, 0U);
+        DRV_FLEXCAN_RegisterMbHandler(FLEXCAN_INSTANCE, mbIdx, &CAN_TxCompleteNotification);
+        DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, mbIdx);
+    }
 
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_CONFIRM_PING_MB, &mbCfg, TX_CONFIRM_PING_ID);
+    CAN_TxBusyMask = 0U;
 }
 
-static void FLEXCAN_Rx_Mb_Init(void)
+static bool FLEXCAN_Rx_Fifo_Init(void)
 {
-    DRV_FLEXCAN_SetRxMbGlobalMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, FLEXCAN_GLOBAL_MASK);
-
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_STOPOPR_MB, FLEXCAN_INDIVIDUAL_MASK);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_CONNECTION_MB, FLEXCAN_INDIVIDUAL_MASK);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_CONFIRM_DATA_MB, FLEXCAN_INDIVIDUAL_MASK);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_PING_MSG_MB, FLEXCAN_INDIVIDUAL_MASK);
+    const flexcan_rx_fifo_config_t rxFifoCfg =
+    {
+        .idFilterTable = CAN_RxFilterTable,
+        .idFilterNum   = (uint8_t)CAN_RX_FILTER_NUM
+    };
 
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_STOPOPR_MB, &mbCfg, RX_MSG_STOPOPR_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_CONNECTION_MB, &mbCfg, RX_MSG_CONNECTION_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_CONFIRM_DATA_MB, &mbCfg, RX_MSG_CONFIRM_DATA_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_PING_MSG_MB, &mbCfg, RX_PING_MSG_ID);
+    /* A new command ID is one more filter element, no mailbox and no mask of its own */
+    if (DRV_FLEXCAN_ConfigRxFifo(FLEXCAN_INSTANCE, &rxFifoCfg) != FLEXCAN_STATUS_SUCCESS)
+    {
+        return false;
+    }
+    DRV_FLEXCAN_RegisterRxFifoCallback(FLEXCAN_INSTANCE, &CAN_RxFifoNotification);
 
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_STOPOPR_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_CONNECTION_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_CONFIRM_DATA_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_PING_MSG_MB);
+    return true;
 }
 
 void MID_CAN_Init(void)
 {
     FLEXCAN_Pin_Init();
-    FLEXCAN_ParamConfig();
-    FLEXCAN_Tx_Mb_Init();
-    FLEXCAN_Rx_Mb_Init();
+    /* Without bit timing the mailboxes cannot be set up either */
+    if (FLEXCAN_ParamConfig() == true)
+    {
+        (void)MID_CAN_MailboxInit();
+    }
+    CAN_TxLimiter_Init();
+    CAN_Supervisor_Init();
 }
 
-void MID_CAN_MailboxInit(void)
+bool MID_CAN_MailboxInit(void)
 {
+    bool fifoOk = false;
+
+    /* One freeze-mode cycle for the whole mailbox, FIFO and interrupt setup */
+    if (DRV_FLEXCAN_BeginConfig(FLEXCAN_INSTANCE) != FLEXCAN_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
     FLEXCAN_Tx_Mb_Init();
-    FLEXCAN_Rx_Mb_Init();
+    fifoOk = FLEXCAN_Rx_Fifo_Init();
+
+    /* Commit in any case, the transaction must be closed */
+    return ((DRV_FLEXCAN_CommitConfig(FLEXCAN_INSTANCE) == FLEXCAN_STATUS_SUCCESS) && (fifoOk == true));
 }
 
-void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(void))
+void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(const Data_Typedef *Message))
 {
-    DRV_FLEXCAN_RegisterMbCallback(FLEXCAN_INSTANCE, cb_ptr);
+    CAN_RxUserCallback = cb_ptr;
 }
 
-void MID_CAN_ReceiveMessage(uint8_t mbIdx, Data_Typedef *data)
+/* Rx FIFO event, called from the CAN ISR once per frame while the FIFO output is held */
+static void CAN_RxFifoNotification(flexcan_rx_fifo_event_t event, const flexcan_mb_view_t *frame)
 {
-    DRV_FLEXCAN_ReceiveInt(FLEXCAN_INSTANCE, mbIdx, &Receive_Message);
+    Data_Typedef message;
+    uint32_t bits    = 0U;
+    uint32_t primask = 0U;
+    uint8_t  i       = 0U;
 
-    data->ID = Receive_Message.msgId;
-    data->Data = Receive_Message.data[0];
+    switch (event)
+    {
+        case FLEXCAN_RX_FIFO_FRAME:
+            CAN_RxStats.Received++;
+
+            bits = CAN_FrameBits(frame->msgId, frame->dataLength,
+                                 FLEXCAN_MB_VIEW_WORD(frame, 0U), FLEXCAN_MB_VIEW_WORD(frame, 1U));
+            primask = NVIC_EnterCritical();
+            for (i = 0U; i < CAN_RX_FILTER_NUM; i++)
+            {
+                if (CAN_RxFilterTable[i].id == frame->msgId)
+                {
+                    CAN_LoadRecord(&CAN_RxIdStats[i], CAN_DIR_RX, frame->dataLength, bits);
+                    break;
+                }
+            }
+            NVIC_ExitCritical(primask);
+
+            /* The view ends here: the application and ISO-TP decode a copy of the two payload
+             * words, valid for the duration of the callback */
+            if (CAN_RxUserCallback != NULL)
+            {
+                message.ID   = frame->msgId;
+                message.Data = FLEXCAN_MB_VIEW_WORD(frame, 0U);
+                message.Data1 = FLEXCAN_MB_VIEW_WORD(frame, 1U);
+                message.DataLength = frame->dataLength;
+                message.TimeStamp = MID_CAN_TimestampToSystem(FLEXCAN_MB_VIEW_TIMESTAMP(frame));
+                CAN_RxUserCallback(&message);
+            }
+            break;
+
+        case FLEXCAN_RX_FIFO_WARNING:
+            CAN_RxStats.Warnings++;
+            break;
+
+        case FLEXCAN_RX_FIFO_OVERFLOW:
+            CAN_RxStats.Overflows++;
+            break;
+
+        default:
+            break;
+    }
 }
 
-void MID_CAN_SendCANMessage(uint8_t Tx_Mb, uint16_t Data)
+/* Write a queued frame into a free pool mailbox, called with interrupts masked */
+static void CAN_TxFill(uint8_t mbIdx, const CAN_TxEntry_Typedef *entry)
 {
-    Transmit_Message.data[0] = Data;
+    const CAN_TxMessage_Typedef *msg = &CAN_TxMessageTable[entry->Msg];
+    volatile uint32_t *payload = DRV_FLEXCAN_GetTxMbPayload(FLEXCAN_INSTANCE, mbIdx);
+
+    CAN_TxMbEntry[mbIdx] = *entry;
+
+    /* Payload is written straight into MB RAM */
+    payload[0] = entry->Data[0];
+    payload[1] = entry->Data[1];
 
-    DRV_FLEXCAN_Transmit(FLEXCAN_INSTANCE, Tx_Mb, &Transmit_Message);
+    CAN_TxBusyMask |= (1UL << mbIdx);
+
+    /* Local priority: a rotation frame outranks a pending confirmation whatever their IDs */
+    DRV_FLEXCAN_CommitTxMb(FLEXCAN_INSTANCE, mbIdx, FLEXCAN_MB_ID_STD, msg->ID, msg->DataLength, msg->Class);
 }
 
-void MID_ClearMessageCommingEvent(uint8_t Mailbox)
+/* Move queued frames to free mailboxes, highest class first, called with interrupts masked */
+static void CAN_TxKick(void)
 {
-    DRV_FLEXCAN_ClearMbIntFlag(FLEXCAN_INSTANCE, Mailbox);
+    uint32_t freeMask = TX_POOL_MB_MASK & ~CAN_TxBusyMask;
+    uint8_t  txClass  = 0U;
+    uint8_t  mbIdx    = 0U;
+    CAN_TxQueue_Typedef *queue = NULL;
+
+    /* Bus-off: frames wait in the queues, where a newer value still replaces an older one */
+    if (CAN_BusState == CAN_BUS_OFF)
+    {
+        return;
+    }
+
+    for (txClass = 0U; (txClass < CAN_TX_CLASS_COUNT) && (freeMask != 0U); txClass++)
+    {
+        queue = &CAN_TxQueue[txClass];
+
+        /* Bulk frames leave mailboxes free, a real-time frame never waits for a whole bulk frame */
+        while ((queue->Count != 0U) && (freeMask != 0U) &&
+               ((txClass != CAN_TX_CLASS_BULK) || ((uint32_t)__builtin_popcount(freeMask) > CAN_TX_BULK_RESERVED_MB)))
+        {
+            mbIdx = (uint8_t)__builtin_ctz(freeMask);
+            freeMask &= ~(1UL << mbIdx);
+
+            CAN_TxFill(mbIdx, &queue->Entries[queue->Head]);
+
+            queue->Head = (uint8_t)((queue->Head + 1U) % CAN_TX_QUEUE_DEPTH);
+            queue->Count--;
+            CAN_TxStats[txClass].Depth = queue->Count;
+        }
+    }
 }
 
-uint8_t MID_CheckCommingMessageEvent(uint8_t Mailbox)
+/* Transmit complete or abort of a pool mailbox, refill it from the queues */
+static void CAN_TxCompleteNotification(uint8_t mbIdx)
 {
-    return DRV_FLEXCAN_GetMbIntFlag(FLEXCAN_INSTANCE, Mailbox);
+    bool     aborted   = (DRV_FLEXCAN_IsTxMbAborted(FLEXCAN_INSTANCE, mbIdx) != 0U);
+    uint32_t wireTime  = 0U;
+    uint32_t latencyUs = 0U;
+    uint32_t frameBits = 0U;
+    uint8_t  txMsg     = 0U;
+    const CAN_TxMessage_Typedef *msg = &CAN_TxMessageTable[CAN_TxMbEntry[mbIdx].Msg];
+    CAN_TxStats_Typedef *stats = &CAN_TxStats[msg->Class];
+    uint32_t primask = 0U;
+
+    if (aborted == false)
+    {
+        /* The time stamp is overwritten by the next frame of the mailbox, read it first */
+        wireTime = MID_CAN_TimestampToSystem(DRV_FLEXCAN_GetMbTimestamp(FLEXCAN_INSTANCE, mbIdx));
+        /* The entry stays as long as the mailbox is busy, size the frame outside the critical section */
+        frameBits = CAN_FrameBits(msg->ID, msg->DataLength, CAN_TxMbEntry[mbIdx].Data[0], CAN_TxMbEntry[mbIdx].Data[1]);
+    }
+
+    primask = NVIC_EnterCritical();
+
+    txMsg = CAN_TxMbEntry[mbIdx].Msg;
+    CAN_TxBusyMask &= ~(1UL << mbIdx);
+
+    if (aborted == true)
+    {
+        /* Replaced by a newer value, or withdrawn at bus-off: back to the queue unless stale */
+        stats->Aborted++;
+        CAN_TxRequeue(&CAN_TxMbEntry[mbIdx]);
+    }
+    else
+    {
+        latencyUs = MID_Timer_TicksToUs(wireTime - CAN_TxMbEntry[mbIdx].QueuedAt);
+        stats->Sent++;
+        CAN_LoadRecord(&CAN_TxIdStats[txMsg], CAN_DIR_TX, msg->DataLength, frameBits);
+        stats->LastLatencyUs = latencyUs;
+        if (latencyUs > stats->MaxLatencyUs)
+        {
+            stats->MaxLatencyUs = latencyUs;
+        }
+    }
+
+    CAN_TxKick();
+
+    NVIC_ExitCritical(primask);
+
+    if ((aborted == false) && (CAN_TxConfirmCallback != NULL))
+    {
+        CAN_TxConfirmCallback(txMsg, wireTime);
+    }
+}
+
+void MID_CAN_RegisterTxConfirmCallback(void (*cb_ptr)(uint8_t Tx_Msg, uint32_t TimeStamp))
+{
+    CAN_TxConfirmCallback = cb_ptr;
+}
+
+uint32_t MID_CAN_TimestampToSystem(uint16_t TimeStamp)
+{
+    uint32_t primask  = NVIC_EnterCritical();
+    uint64_t frameBit = DRV_FLEXCAN_ExtendTimestamp(FLEXCAN_INSTANCE, TimeStamp);
+    /* Sample both time bases back to back */
+    uint32_t nowTick  = MID_Timer_GetTimestamp();
+    uint64_t nowBit   = DRV_FLEXCAN_GetTimer64(FLEXCAN_INSTANCE);
+
+    NVIC_ExitCritical(primask);
+
+    /* Less than 65536 bit times apart: 524 ms at 125 kbit/s, well inside the 32-bit tick range */
+    return nowTick - MID_Timer_UsToTicks((uint32_t)(nowBit - frameBit) * FLEXCAN_BIT_TIME_US);
+}
+
+/* Put a frame withdrawn from a mailbox back at the head of its queue, called with interrupts masked */
+static void CAN_TxRequeue(const CAN_TxEntry_Typedef *entry)
+{
+    const CAN_TxMessage_Typedef *msg = &CAN_TxMessageTable[entry->Msg];
+    CAN_TxQueue_Typedef *queue = &CAN_TxQueue[msg->Class];
+    CAN_TxStats_Typedef *stats = &CAN_TxStats[msg->Class];
+    uint32_t busyMask = CAN_TxBusyMask;
+    uint8_t mbIdx = 0U;
+    uint8_t i = 0U;
+
+    /* A queued frame of a latest-value-wins message is newer, keep that one */
+    for (i = 0U; (i < queue->Count) && (msg->LatestWins == true); i++)
+    {
+        if (queue->Entries[(queue->Head + i) % CAN_TX_QUEUE_DEPTH].Msg == entry->Msg)
+        {
+            stats->Replaced++;
+            return;
+        }
+    }
+
+    /* So is a newer frame of it still pending in another mailbox */
+    while ((busyMask != 0U) && (msg->LatestWins == true))
+    {
+        mbIdx = (uint8_t)__builtin_ctz(busyMask);
+        busyMask &= ~(1UL << mbIdx);
+
+        if ((CAN_TxMbEntry[mbIdx].Msg == entry->Msg) &&
+            ((int32_t)(CAN_TxMbEntry[mbIdx].QueuedAt - entry->QueuedAt) >= 0))
+        {
+            stats->Replaced++;
+            return;
+        }
+    }
+
+    if (queue->Count < CAN_TX_QUEUE_DEPTH)
+    {
+        queue->Head = (uint8_t)((queue->Head + CAN_TX_QUEUE_DEPTH - 1U) % CAN_TX_QUEUE_DEPTH);
+        queue->Entries[queue->Head] = *entry;
+        queue->Count++;
+
+        stats->Depth = queue->Count;
+        if (stats->Depth > stats->MaxDepth)
+        {
+            stats->MaxDepth = stats->Depth;
+        }
+        CAN_ErrorStats.Requeued++;
+    }
+    else
+    {
+        stats->Dropped++;
+    }
+}
+
+/* Update in place: abort the pending frames of a message a newer value supersedes,
+ * called with interrupts masked before the newer value is moved to a mailbox */
+static void CAN_TxAbortStale(uint8_t Tx_Msg)
+{
+    uint32_t busyMask = CAN_TxBusyMask;
+    uint8_t  mbIdx    = 0U;
+
+    while (busyMask != 0U)
+    {
+        mbIdx = (uint8_t)__builtin_ctz(busyMask);
+        busyMask &= ~(1UL << mbIdx);
+
+        if (CAN_TxMbEntry[mbIdx].Msg == Tx_Msg)
+        {
+            /* Completes in CAN_TxCompleteNotification, as sent if it already won arbitration */
+            (void)DRV_FLEXCAN_AbortTxMb(FLEXCAN_INSTANCE, mbIdx);
+        }
+    }
+}
+
+uint8_t MID_CAN_SendCANMessage(uint8_t Tx_Msg, uint16_t Data)
+{
+    return MID_CAN_SendCANFrame(Tx_Msg, Data, 0U);
+}
+
+uint8_t MID_CAN_SendCANFrame(uint8_t Tx_Msg, uint32_t Data0, uint32_t Data1)
+{
+    const CAN_TxMessage_Typedef *msg = NULL;
+    CAN_TxBucket_Typedef *bucket = NULL;
+    uint32_t primask = 0U;
+    uint32_t now     = 0U;
+    uint8_t  retVal  = CAN_TX_OK;
+
+    if (Tx_Msg >= TX_MSG_COUNT)
+    {
+        return CAN_TX_INVALID_MSG;
+    }
+
+    /* Only the constant message table is read outside the critical section */
+    msg    = &CAN_TxMessageTable[Tx_Msg];
+    bucket = &CAN_TxBuckets[Tx_Msg];
+
+    primask = NVIC_EnterCritical();
+
+    /* Read with interrupts masked: a refill from an ISR in between would leave
+     * RefilledAt ahead of now */
+    now = MID_Timer_GetTimestamp();
+
+    if (msg->RateHz == 0U)
+    {
+        retVal = CAN_TxEnqueue(Tx_Msg, Data0, Data1, now);
+    }
+    else
+    {
+        CAN_TxRefill(Tx_Msg, now);
+
+        /* A held frame goes first, a new value never overtakes it */
+        if (((CAN_TxHeldMask & (1UL << Tx_Msg)) == 0U) && (bucket->Tokens >= CAN_TX_TOKEN))
+        {
+            bucket->Tokens -= CAN_TX_TOKEN;
+            retVal = CAN_TxEnqueue(Tx_Msg, Data0, Data1, now);
+        }
+        else
+        {
+            retVal = CAN_TxHold(Tx_Msg, Data0, Data1, now);
+            CAN_TxRelease(Tx_Msg);
+        }
+    }
+
+    NVIC_ExitCritical(primask);
+
+    return retVal;
+}
+
+/* Queue a frame in its class, called with interrupts masked */
+static uint8_t CAN_TxEnqueue(uint8_t Tx_Msg, uint32_t Data0, uint32_t Data1, uint32_t QueuedAt)
+{
+    const CAN_TxMessage_Typedef *msg = &CAN_TxMessageTable[Tx_Msg];
+    CAN_TxQueue_Typedef *queue = &CAN_TxQueue[msg->Class];
+    CAN_TxStats_Typedef *stats = &CAN_TxStats[msg->Class];
+    CAN_TxEntry_Typedef *entry = NULL;
+    uint8_t  retVal  = CAN_TX_OK;
+    uint8_t  i       = 0U;
+
+    /* Latest value wins: update a frame of the same message still waiting in the queue */
+    for (i = 0U; (i < queue->Count) && (msg->LatestWins == true) && (entry == NULL); i++)
+    {
+        if (queue->Entries[(queue->Head + i) % CAN_TX_QUEUE_DEPTH].Msg == Tx_Msg)
+        {
+            entry = &queue->Entries[(queue->Head + i) % CAN_TX_QUEUE_DEPTH];
+            stats->Replaced++;
+            retVal = CAN_TX_REPLACED;
+        }
+    }
+
+    if ((entry == NULL) && (queue->Count < CAN_TX_QUEUE_DEPTH))
+    {
+        entry = &queue->Entries[(queue->Head + queue->Count) % CAN_TX_QUEUE_DEPTH];
+        entry->Msg = Tx_Msg;
+        queue->Count++;
+
+        stats->Depth = queue->Count;
+        if (stats->Depth > stats->MaxDepth)
+        {
+            stats->MaxDepth = stats->Depth;
+        }
+    }
+
+    if (entry != NULL)
+    {
+        entry->Data[0]  = Data0;
+        entry->Data[1]  = Data1;
+        entry->QueuedAt = QueuedAt;
+
+        if (msg->LatestWins == true)
+        {
+            CAN_TxAbortStale(Tx_Msg);
+        }
+
+        CAN_TxKick();
+    }
+    else
+    {
+        /* Back-pressure: the caller keeps the value and may retry */
+        stats->Dropped++;
+        retVal = CAN_TX_QUEUE_FULL;
+    }
+
+    return retVal;
+}
+
+static void CAN_TxLimiter_Init(void)
+{
+    uint32_t now = MID_Timer_GetTimestamp();
+    uint8_t  txMsg = 0U;
+
+    /* Start with full buckets, the first burst goes out at once */
+    for (txMsg = 0U; txMsg < TX_MSG_COUNT; txMsg++)
+    {
+        CAN_TxBuckets[txMsg].Tokens = (uint32_t)CAN_TxMessageTable[txMsg].Burst * CAN_TX_TOKEN;
+        CAN_TxBuckets[txMsg].RefilledAt = now;
+    }
+
+    CAN_TxHeldMask = 0U;
+}
+
+/* Add the tokens earned since the last refill, called with interrupts masked */
+static void CAN_TxRefill(uint8_t Tx_Msg, uint32_t now)
+{
+    const CAN_TxMessage_Typedef *msg = &CAN_TxMessageTable[Tx_Msg];
+    CAN_TxBucket_Typedef *bucket = &CAN_TxBuckets[Tx_Msg];
+    uint32_t full      = (uint32_t)msg->Burst * CAN_TX_TOKEN;
+    uint32_t elapsedUs = MID_Timer_TicksToUs(now - bucket->RefilledAt);
+
+    bucket->RefilledAt = now;
+
+    /* Compare first: elapsedUs x RateHz overflows after a long quiet period */
+    if (elapsedUs >= ((full - bucket->Tokens) / msg->RateHz))
+    {
+        bucket->Tokens = full;
+    }
+    else
+    {
+        bucket->Tokens += elapsedUs * msg->RateHz;
+    }
+}
+
+/* Hold a frame without a token, called with interrupts masked */
+static uint8_t CAN_TxHold(uint8_t Tx_Msg, uint32_t Data0, uint32_t Data1, uint32_t QueuedAt)
+{
+    const CAN_TxMessage_Typedef *msg = &CAN_TxMessageTable[Tx_Msg];
+    CAN_TxStats_Typedef *stats = &CAN_TxStats[msg->Class];
+    CAN_TxEntry_Typedef *held = &CAN_TxHeld[Tx_Msg];
+
+    if ((CAN_TxHeldMask & (1UL << Tx_Msg)) == 0U)
+    {
+        held->Msg = Tx_Msg;
+        CAN_TxHeldMask |= (1UL << Tx_Msg);
+    }
+    else if (msg->LatestWins == true)
+    {
+        /* Coalesced: the held frame carries the newer value */
+        stats->Replaced++;
+    }
+    else
+    {
+        stats->Dropped++;
+        return CAN_TX_QUEUE_FULL;
+    }
+
+    held->Data[0]  = Data0;
+    held->Data[1]  = Data1;
+    held->QueuedAt = QueuedAt;
+    stats->Throttled++;
+
+    return CAN_TX_THROTTLED;
+}
+
+/* Queue the held frame of a message once it has a token, called with interrupts masked */
+static void CAN_TxRelease(uint8_t Tx_Msg)
+{
+    CAN_TxBucket_Typedef *bucket = &CAN_TxBuckets[Tx_Msg];
+    const CAN_TxEntry_Typedef *held = &CAN_TxHeld[Tx_Msg];
+
+    if (((CAN_TxHeldMask & (1UL << Tx_Msg)) != 0U) && (bucket->Tokens >= CAN_TX_TOKEN))
+    {
+        bucket->Tokens -= CAN_TX_TOKEN;
+        CAN_TxHeldMask &= ~(1UL << Tx_Msg);
+        (void)CAN_TxEnqueue(Tx_Msg, held->Data[0], held->Data[1], held->QueuedAt);
+    }
+}
+
+void MID_CAN_GetTxStats(uint8_t Tx_Class, CAN_TxStats_Typedef *stats)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    *stats = CAN_TxStats[Tx_Class];
+
+    NVIC_ExitCritical(primask);
+}
+
+void MID_CAN_GetRxStats(CAN_RxStats_Typedef *stats)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    *stats = CAN_RxStats;
+
+    NVIC_ExitCritical(primask);
+}
+
+static void CAN_Supervisor_Init(void)
+{
+    uint8_t timerId = MID_SwTimer_Create(&CAN_SupervisorTick, SW_TIMER_CONTEXT_ISR);
+
+    /* With a back-off policy the supervisor decides when the controller may rejoin */
+    DRV_FLEXCAN_SetBusOffRecovery(FLEXCAN_INSTANCE, (CAN_BUSOFF_BACKOFF_BASE_MS == 0u) ? 1U : 0U);
+    (void)DRV_FLEXCAN_RegisterErrorCallback(FLEXCAN_INSTANCE, &CAN_ErrorNotification);
+
+    if (timerId != SW_TIMER_INVALID_ID)
+    {
+        MID_SwTimer_Start(timerId, CAN_SUPERVISOR_PERIOD_MS, SW_TIMER_PERIODIC);
+    }
+}
+
+/* Error and bus state interrupt of the controller */
+static void CAN_ErrorNotification(uint32_t events)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    if ((events & FLEXCAN_ERROR_EVENT_BUS_OFF) != 0U)
+    {
+        CAN_BusOffEnter();
+    }
+    if ((events & FLEXCAN_ERROR_EVENT_BUS_OFF_DONE) != 0U)
+    {
+        CAN_BusOffExit();
+    }
+    if ((events & (FLEXCAN_ERROR_EVENT_TX_WARNING | FLEXCAN_ERROR_EVENT_RX_WARNING)) != 0U)
+    {
+        CAN_ErrorStats.Warnings++;
+    }
+
+    NVIC_ExitCritical(primask);
+}
+
+/* Withdraw the pending frames and start the back-off, called with interrupts masked */
+static void CAN_BusOffEnter(void)
+{
+    uint32_t busyMask = CAN_TxBusyMask;
+    uint32_t now      = MID_Timer_GetTimestamp();
+    uint8_t  mbIdx    = 0U;
+
+    CAN_ErrorStats.BusOffs++;
+    CAN_BusState = CAN_BUS_OFF;
+    CAN_BusOffTimestamp = now;
+
+    /* A bus-off long after the last recovery starts a new burst */
+    if ((CAN_BusOffBurst != 0U) &&
+        (MID_Timer_TicksToUs(now - CAN_RecoveryTimestamp) >= (CAN_BUSOFF_STABLE_MS * 1000u)))
+    {
+        CAN_BusOffBurst = 0U;
+    }
+    if (CAN_BusOffBurst < (CAN_BUSOFF_BACKOFF_MAX_SHIFT + 1U))
+    {
+        CAN_BusOffBurst++;
+    }
+
+    /* Frames still in the mailboxes are aborted and go back to the queues from their
+     * mailbox interrupt, so the latest value is what is sent after the rejoin instead of
+     * a value that went stale during the back-off */
+    while (busyMask != 0U)
+    {
+        mbIdx = (uint8_t)__builtin_ctz(busyMask);
+        busyMask &= ~(1UL << mbIdx);
+
+        (void)DRV_FLEXCAN_AbortTxMb(FLEXCAN_INSTANCE, mbIdx);
+    }
+
+    if (CAN_BUSOFF_BACKOFF_BASE_MS == 0u)
+    {
+        /* Automatic recovery, nothing to release */
+    }
+    else if (CAN_BusOffBurst == 1U)
+    {
+        /* First bus-off: rejoin after the 128 x 11 recessive bits */
+        CAN_BackoffMs = 0U;
+        DRV_FLEXCAN_SetBusOffRecovery(FLEXCAN_INSTANCE, 1U);
+    }
+    else
+    {
+        CAN_BackoffMs = (uint32_t)CAN_BUSOFF_BACKOFF_BASE_MS << (CAN_BusOffBurst - 2U);
+        if (CAN_BackoffMs > CAN_BUSOFF_BACKOFF_MAX_MS)
+        {
+            CAN_BackoffMs = CAN_BUSOFF_BACKOFF_MAX_MS;
+        }
+    }
+}
+
+/* Back on the bus, refill the mailboxes, called with interrupts masked */
+static void CAN_BusOffExit(void)
+{
+    uint32_t now = MID_Timer_GetTimestamp();
+    uint32_t recoveryUs = MID_Timer_TicksToUs(now - CAN_BusOffTimestamp);
+
+    if (CAN_BUSOFF_BACKOFF_BASE_MS != 0u)
+    {
+        /* Hold the next bus-off until the supervisor releases it */
+        DRV_FLEXCAN_SetBusOffRecovery(FLEXCAN_INSTANCE, 0U);
+    }
+
+    CAN_BackoffMs = 0U;
+    CAN_BusState = CAN_BUS_ERROR_ACTIVE;
+    CAN_RecoveryTimestamp = now;
+
+    CAN_ErrorStats.Recoveries++;
+    CAN_ErrorStats.LastRecoveryUs = recoveryUs;
+    if (recoveryUs > CAN_ErrorStats.MaxRecoveryUs)
+    {
+        CAN_ErrorStats.MaxRecoveryUs = recoveryUs;
+    }
+
+    CAN_TxKick();
+}
+
+/* Periodic supervision: error passive tracking, CAN timer rollover and the back-off countdown */
+static void CAN_SupervisorTick(void)
+{
+    flexcan_error_state_t errState;
+    uint8_t  txMsg   = 0U;
+    uint32_t primask = NVIC_EnterCritical();
+    uint32_t now     = MID_Timer_GetTimestamp();
+
+    DRV_FLEXCAN_GetErrorState(FLEXCAN_INSTANCE, &errState);
+
+    /* Keeps the 64-bit extension of the 16-bit CAN timer, which wraps after 131 ms at 500 kbit/s */
+    (void)DRV_FLEXCAN_GetTimer64(FLEXCAN_INSTANCE);
+
+    CAN_LoadTick(&errState);
+
+    /* Refilling every tick keeps the elapsed time far from the timestamp wrap, and a held
+     * frame waits at most one tick past its token */
+    for (txMsg = 0U; txMsg < TX_MSG_COUNT; txMsg++)
+    {
+        if (CAN_TxMessageTable[txMsg].RateHz != 0U)
+        {
+            CAN_TxRefill(txMsg, now);
+            CAN_TxRelease(txMsg);
+        }
+    }
+
+    /* Bus-off is entered and left through the interrupts */
+    if (CAN_BusState != CAN_BUS_OFF)
+    {
+        if ((errState.faultState == FLEXCAN_ERROR_PASSIVE) && (CAN_BusState == CAN_BUS_ERROR_ACTIVE))
+        {
+            CAN_ErrorStats.ErrorPassive++;
+        }
+        CAN_BusState = (errState.faultState == FLEXCAN_ERROR_PASSIVE) ? CAN_BUS_ERROR_PASSIVE : CAN_BUS_ERROR_ACTIVE;
+    }
+
+    if (CAN_BackoffMs != 0U)
+    {
+        CAN_BackoffMs = (CAN_BackoffMs > CAN_SUPERVISOR_PERIOD_MS) ? (CAN_BackoffMs - CAN_SUPERVISOR_PERIOD_MS) : 0U;
+        if (CAN_BackoffMs == 0U)
+        {
+            DRV_FLEXCAN_SetBusOffRecovery(FLEXCAN_INSTANCE, 1U);
+        }
+    }
+
+    NVIC_ExitCritical(primask);
+}
+
+void MID_CAN_GetErrorStats(CAN_ErrorStats_Typedef *stats)
+{
+    flexcan_error_state_t errState;
+    uint32_t primask = NVIC_EnterCritical();
+
+    DRV_FLEXCAN_GetErrorState(FLEXCAN_INSTANCE, &errState);
+
+    *stats = CAN_ErrorStats;
+    stats->State    = CAN_BusState;
+    stats->TxErrCnt = errState.txErrCnt;
+    stats->RxErrCnt = errState.rxErrCnt;
+
+    NVIC_ExitCritical(primask);
+}
+
+/* Feeds count bits of value, most significant first, to the CRC-15 when crc is set and
+ * counts the stuff bits: after five equal bits the transmitter inserts one of opposite
+ * level, which starts the next run */
+static void CAN_FeedBits(CAN_BitStream_Typedef *stream, uint32_t value, uint8_t count, bool crc)
+{
+    uint8_t bit = 0U;
+
+    while (count > 0U)
+    {
+        count--;
+        bit = (uint8_t)((value >> count) & 1U);
+
+        if (crc == true)
+        {
+            stream->Crc = (uint16_t)((stream->Crc << 1U) & 0x7FFFU) ^
+                          (((bit ^ (stream->Crc >> 14U)) & 1U) ? CAN_CRC15_POLY : 0U);
+        }
+
+        if ((bit == stream->Level) && (stream->Run != 0U))
+        {
+            stream->Run++;
+            if (stream->Run == 5U)
+            {
+                stream->Stuff++;
+                stream->Level ^= 1U;
+                stream->Run = 1U;
+            }
+        }
+        else
+        {
+            stream->Level = bit;
+            stream->Run = 1U;
+        }
+    }
+}
+
+/* Bit times a classic base-format data frame takes on the bus, intermission included.
+ * The stuff bits are counted on the actual ID, payload and CRC rather than taken from
+ * the worst-case bound (33 + 8 x len) / 4, which would overstate the load of typical
+ * payloads by about 15 % */
+static uint32_t CAN_FrameBits(uint32_t id, uint8_t len, uint32_t data0, uint32_t data1)
+{
+    CAN_BitStream_Typedef stream = { 0U, 0U, 0U, 0U };
+    uint8_t i = 0U;
+
+    if (len > FLEXCAN_DATA_LENGTH)
+    {
+        len = FLEXCAN_DATA_LENGTH;
+    }
+
+    /* SOF, 11-bit ID, RTR, IDE and r0 all dominant, DLC */
+    CAN_FeedBits(&stream, ((id & 0x7FFU) << 7U) | len, 19U, true);
+    for (i = 0U; i < len; i++)
+    {
+        CAN_FeedBits(&stream, (((i < 4U) ? data0 : data1) >> (24U - (8U * (i & 3U)))), 8U, true);
+    }
+    CAN_FeedBits(&stream, stream.Crc, 15U, false);
+
+    return CAN_FRAME_STUFFED_BITS(len) + CAN_FRAME_TRAILER_BITS + stream.Stuff;
+}
+
+/* Accounts a frame to its ID and to the bucket being filled, called with interrupts masked */
+static void CAN_LoadRecord(CAN_IdStats_Typedef *idStats, uint8_t direction, uint8_t len, uint32_t bits)
+{
+    CAN_LoadBucket_Typedef *bucket = &CAN_LoadBuckets[CAN_LoadBucketIdx];
+
+    idStats->Frames++;
+    idStats->Bytes += len;
+    idStats->BitTimes += bits;
+
+    if (direction == CAN_DIR_TX)
+    {
+        bucket->TxBits += bits;
+        bucket->TxFrames++;
+    }
+    else
+    {
+        bucket->RxBits += bits;
+        bucket->RxFrames++;
+    }
+}
+
+/* Error counter history and window slide, from the supervisor tick with interrupts masked */
+static void CAN_LoadTick(const flexcan_error_state_t *errState)
+{
+    CAN_LoadBucket_Typedef *bucket = &CAN_LoadBuckets[CAN_LoadBucketIdx];
+    CAN_BusLoad_Typedef load;
+
+    if (errState->txErrCnt > bucket->MaxTxErrCnt)
+    {
+        bucket->MaxTxErrCnt = errState->txErrCnt;
+    }
+    if (errState->rxErrCnt > bucket->MaxRxErrCnt)
+    {
+        bucket->MaxRxErrCnt = errState->rxErrCnt;
+    }
+
+    CAN_LoadBucketTicks++;
+    if (CAN_LoadBucketTicks < CAN_LOAD_BUCKET_TICKS)
+    {
+        return;
+    }
+
+    /* The filled bucket joins the window, the oldest one is reused */
+    CAN_LoadBucketTicks = 0U;
+    CAN_LoadBucketIdx = (uint8_t)((CAN_LoadBucketIdx + 1U) % (CAN_LOAD_BUCKET_COUNT + 1U));
+    CAN_LoadBuckets[CAN_LoadBucketIdx] = (CAN_LoadBucket_Typedef){ 0U, 0U, 0U, 0U, 0U, 0U };
+
+    CAN_LoadWindow(&load);
+    if ((uint32_t)load.TxLoad + load.RxLoad > CAN_PeakLoad)
+    {
+        CAN_PeakLoad = (uint16_t)((uint32_t)load.TxLoad + load.RxLoad);
+    }
+}
+
+/* Sums the buckets of the last complete window, called with interrupts masked */
+static void CAN_LoadWindow(CAN_BusLoad_Typedef *load)
+{
+    const CAN_LoadBucket_Typedef *bucket = NULL;
+    uint32_t txBits = 0U;
+    uint32_t rxBits = 0U;
+    uint8_t  i = 0U;
+
+    *load = (CAN_BusLoad_Typedef){ 0U, 0U, 0U, 0U, 0U, 0U, 0U };
+
+    for (i = 0U; i < (CAN_LOAD_BUCKET_COUNT + 1U); i++)
+    {
+        if (i == CAN_LoadBucketIdx)
+        {
+            continue;
+        }
+
+        bucket = &CAN_LoadBuckets[i];
+        txBits += bucket->TxBits;
+        rxBits += bucket->RxBits;
+        load->TxFrames += bucket->TxFrames;
+        load->RxFrames += bucket->RxFrames;
+        if (bucket->MaxTxErrCnt > load->MaxTxErrCnt)
+        {
+            load->MaxTxErrCnt = bucket->MaxTxErrCnt;
+        }
+        if (bucket->MaxRxErrCnt > load->MaxRxErrCnt)
+        {
+            load->MaxRxErrCnt = bucket->MaxRxErrCnt;
+        }
+    }
+
+    load->TxLoad = (uint16_t)(((uint64_t)txBits * 10000u) / CAN_LOAD_WINDOW_BITS);
+    load->RxLoad = (uint16_t)(((uint64_t)rxBits * 10000u) / CAN_LOAD_WINDOW_BITS);
+    load->PeakLoad = CAN_PeakLoad;
+}
+
+void MID_CAN_GetBusLoad(CAN_BusLoad_Typedef *load)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    CAN_LoadWindow(load);
+
+    NVIC_ExitCritical(primask);
+}
+
+bool MID_CAN_GetIdStats(uint8_t Direction, uint8_t Index, CAN_IdStats_Typedef *stats)
+{
+    uint32_t primask = 0U;
+
+    if ((Direction == CAN_DIR_TX) && (Index < TX_MSG_COUNT))
+    {
+        primask = NVIC_EnterCritical();
+        *stats = CAN_TxIdStats[Index];
+        NVIC_ExitCritical(primask);
+        stats->ID = CAN_TxMessageTable[Index].ID;
+    }
+    else if ((Direction == CAN_DIR_RX) && (Index < CAN_RX_FILTER_NUM))
+    {
+        primask = NVIC_EnterCritical();
+        *stats = CAN_RxIdStats[Index];
+        NVIC_ExitCritical(primask);
+        stats->ID = CAN_RxFilterTable[Index].id;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
 }
@@ -0,0 +1,779 @@
+/*
+ *  Filename: MID_IsoTp_Interface.c
+ *
+ *  Created on: 18-10-2026
+*/
+
+#include <stddef.h>
+#include "DRV_S32K144_NVIC.h"
+#include "MID_Timer_Interface.h"
+#include "MID_IsoTp_Interface.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define ISOTP_FRAME_LENGTH      (8U)
+#define ISOTP_MAX_LENGTH        (4095U)
+#define ISOTP_SF_MAX_DATA       (7U)
+#define ISOTP_FF_DATA           (6U)
+#define ISOTP_CF_MAX_DATA       (7U)
+
+#define ISOTP_PCI_TYPE_MASK     (0xF0U)
+#define ISOTP_PCI_INFO_MASK     (0x0FU)
+#define ISOTP_PCI_SF            (0x00U)
+#define ISOTP_PCI_FF            (0x10U)
+#define ISOTP_PCI_CF            (0x20U)
+#define ISOTP_PCI_FC            (0x30U)
+
+#define ISOTP_FC_CTS            (0U)
+#define ISOTP_FC_WAIT           (1U)
+#define ISOTP_FC_OVERFLOW       (2U)
+
+#define ISOTP_STMIN_MAX_MS      (0x7FU)
+#define ISOTP_STMIN_US_FIRST    (0xF1U)
+#define ISOTP_STMIN_US_LAST     (0xF9U)
+
+#define ISOTP_TICK_MS           (1U)
+
+/* Transfer still running, no end of transfer to report */
+#define ISOTP_PENDING           (0xFFU)
+
+typedef enum
+{
+    ISOTP_TX_IDLE,
+    ISOTP_TX_SF,            /* Single frame pending                        */
+    ISOTP_TX_FF,            /* First frame pending                         */
+    ISOTP_TX_WAIT_FC,       /* First frame or last CF of a block sent      */
+    ISOTP_TX_CF,            /* Consecutive frame pending                   */
+    ISOTP_TX_STMIN          /* Separation time before the next CF          */
+} IsoTp_TxState;
+
+/* IDs of one channel */
+typedef struct
+{
+    uint32_t RxId;
+    uint8_t  TxMsg;         /* SF, FF and CF */
+    uint8_t  FcMsg;         /* Flow control, its own Tx message so its confirmation is told apart */
+} IsoTp_ChannelConfig_Typedef;
+
+/* Sender side of a channel */
+typedef struct
+{
+    IsoTp_TxState  State;
+    const uint8_t *Data;
+    uint16_t Length;
+    uint16_t Offset;        /* Next byte to send                 */
+    uint16_t TimerMs;       /* N_Bs or STmin countdown            */
+    uint8_t  Sequence;
+    uint8_t  BlockSize;     /* From the receiver, 0 = no limit    */
+    uint8_t  BlockCount;
+    uint8_t  StMinMs;
+    uint8_t  WaitCount;
+    bool     FcDeferred;    /* Flow control received before the frame it answers was confirmed */
+    uint8_t  FcFrame[3];    /* FS, BS and STmin of the deferred flow control                    */
+} IsoTp_TxChannel_Typedef;
+
+/* Receiver side of a channel */
+typedef struct
+{
+    bool     Receiving;
+    uint16_t Length;
+    uint16_t Offset;        /* Next byte to receive              */
+    uint16_t TimerMs;       /* N_Cr countdown                     */
+    uint8_t  Sequence;
+    uint8_t  BlockCount;
+    uint8_t  Buffer[ISOTP_RX_BUFFER_SIZE];
+} IsoTp_RxChannel_Typedef;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static uint8_t IsoTp_FindChannelByRxId(uint32_t Id);
+static uint8_t IsoTp_GetByte(const Data_Typedef *Message, uint8_t Index);
+static bool IsoTp_SendFrame(uint8_t Tx_Msg, const uint8_t *Frame);
+static bool IsoTp_SendFlowControl(uint8_t Channel, uint8_t FlowStatus);
+static uint8_t IsoTp_StMinToMs(uint8_t StMin);
+static void IsoTp_TickStart(void);
+static void IsoTp_TxEnd(uint8_t Channel, uint8_t Result);
+static uint8_t IsoTp_TxNextFrame(uint8_t Channel);
+static uint8_t IsoTp_TxWaitFlowControl(uint8_t Channel, bool FcDeferred);
+static uint8_t IsoTp_TxApplyFlowControl(uint8_t Channel, const uint8_t *FcFrame);
+static uint8_t IsoTp_TxFlowControl(uint8_t Channel, const Data_Typedef *Message);
+static uint16_t IsoTp_RxSingle(uint8_t Channel, const Data_Typedef *Message);
+static void IsoTp_RxFirst(uint8_t Channel, const Data_Typedef *Message);
+static uint16_t IsoTp_RxConsecutive(uint8_t Channel, const Data_Typedef *Message);
+static void IsoTp_RxAbort(uint8_t Channel);
+static void IsoTp_Tick(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const IsoTp_ChannelConfig_Typedef IsoTp_ChannelConfig[ISOTP_CHANNEL_COUNT] =
+{
+    { RX_MSG_ISOTP_CH0_ID, TX_ISOTP_CH0_MSG, TX_ISOTP_CH0_FC_MSG },
+    { RX_MSG_ISOTP_CH1_ID, TX_ISOTP_CH1_MSG, TX_ISOTP_CH1_FC_MSG }
+};
+
+static IsoTp_TxChannel_Typedef IsoTp_Tx[ISOTP_CHANNEL_COUNT];
+static IsoTp_RxChannel_Typedef IsoTp_Rx[ISOTP_CHANNEL_COUNT];
+
+static IsoTp_Stats_Typedef IsoTp_Stats;
+
+static void (*IsoTp_RxCallback)(uint8_t Channel, const uint8_t *Data, uint16_t Length) = NULL;
+static void (*IsoTp_TxDoneCallback)(uint8_t Channel, uint8_t Result) = NULL;
+
+/* Timeouts and STmin, runs only while a transfer is in progress */
+static uint8_t IsoTp_TimerId = SW_TIMER_INVALID_ID;
+static bool    IsoTp_TickRunning = false;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void MID_IsoTp_Init(void)
+{
+    uint8_t i = 0U;
+
+    for (i = 0U; i < ISOTP_CHANNEL_COUNT; i++)
+    {
+        IsoTp_Tx[i].State     = ISOTP_TX_IDLE;
+        IsoTp_Rx[i].Receiving = false;
+    }
+
+    IsoTp_TimerId = MID_SwTimer_Create(&IsoTp_Tick, SW_TIMER_CONTEXT_ISR);
+    IsoTp_TickRunning = false;
+}
+
+static uint8_t IsoTp_FindChannelByRxId(uint32_t Id)
+{
+    uint8_t i = 0U;
+
+    for (i = 0U; (i < ISOTP_CHANNEL_COUNT) && (IsoTp_ChannelConfig[i].RxId != Id); i++)
+    {
+    }
+
+    return i;
+}
+
+/* Payload byte of a received frame, byte 0 is the most significant byte of word 0 */
+static uint8_t IsoTp_GetByte(const Data_Typedef *Message, uint8_t Index)
+{
+    uint32_t word = (Index < 4U) ? Message->Data : Message->Data1;
+
+    return (uint8_t)(word >> (24U - (8U * (Index % 4U))));
+}
+
+static bool IsoTp_SendFrame(uint8_t Tx_Msg, const uint8_t *Frame)
+{
+    uint32_t data0 = ((uint32_t)Frame[0] << 24U) | ((uint32_t)Frame[1] << 16U) | ((uint32_t)Frame[2] << 8U) | Frame[3];
+    uint32_t data1 = ((uint32_t)Frame[4] << 24U) | ((uint32_t)Frame[5] << 16U) | ((uint32_t)Frame[6] << 8U) | Frame[7];
+
+    return (MID_CAN_SendCANFrame(Tx_Msg, data0, data1) == CAN_TX_OK);
+}
+
+static bool IsoTp_SendFlowControl(uint8_t Channel, uint8_t FlowStatus)
+{
+    uint8_t frame[ISOTP_FRAME_LENGTH] =
+    {
+        ISOTP_PCI_FC | FlowStatus, ISOTP_RX_BLOCK_SIZE, ISOTP_RX_STMIN,
+        ISOTP_PADDING, ISOTP_PADDING, ISOTP_PADDING, ISOTP_PADDING, ISOTP_PADDING
+    };
+
+    return IsoTp_SendFrame(IsoTp_ChannelConfig[Channel].FcMsg, frame);
+}
+
+/* Separation time requested by the receiver, in ms of countdown */
+static uint8_t IsoTp_StMinToMs(uint8_t StMin)
+{
+    uint8_t retVal = ISOTP_STMIN_MAX_MS;
+
+    if (StMin <= ISOTP_STMIN_MAX_MS)
+    {
+        retVal = StMin;
+    }
+    else if ((StMin >= ISOTP_STMIN_US_FIRST) && (StMin <= ISOTP_STMIN_US_LAST))
+    {
+        /* 100..900 us, rounded up to the timer resolution */
+        retVal = ISOTP_TICK_MS;
+    }
+    else
+    {
+        /* Reserved values are taken as the longest separation time */
+    }
+
+    /* The first tick comes anywhere within the current one, wait one more to never be early */
+    return (retVal == 0U) ? 0U : (uint8_t)(retVal + 1U);
+}
+
+/* Called with interrupts masked */
+static void IsoTp_TickStart(void)
+{
+    if (IsoTp_TickRunning == false)
+    {
+        IsoTp_TickRunning = true;
+        MID_SwTimer_Start(IsoTp_TimerId, ISOTP_TICK_MS, SW_TIMER_PERIODIC);
+    }
+}
+
+uint8_t MID_IsoTp_Send(uint8_t Channel, const uint8_t *Data, uint16_t Length)
+{
+    IsoTp_TxChannel_Typedef *tx = NULL;
+    uint8_t  frame[ISOTP_FRAME_LENGTH];
+    uint8_t  retVal  = ISOTP_OK;
+    uint8_t  first   = 0U;
+    uint8_t  count   = 0U;
+    uint8_t  i       = 0U;
+    uint32_t primask = 0U;
+
+    if ((Channel >= ISOTP_CHANNEL_COUNT) || (Data == NULL) || (Length == 0U) || (Length > ISOTP_MAX_LENGTH))
+    {
+        return ISOTP_INVALID;
+    }
+
+    tx = &IsoTp_Tx[Channel];
+
+    for (i = 0U; i < ISOTP_FRAME_LENGTH; i++)
+    {
+        frame[i] = ISOTP_PADDING;
+    }
+
+    if (Length <= ISOTP_SF_MAX_DATA)
+    {
+        frame[0] = ISOTP_PCI_SF | (uint8_t)Length;
+        first = 1U;
+        count = (uint8_t)Length;
+    }
+    else
+    {
+        frame[0] = ISOTP_PCI_FF | (uint8_t)(Length >> 8U);
+        frame[1] = (uint8_t)Length;
+        first = 2U;
+        count = ISOTP_FF_DATA;
+    }
+
+    for (i = 0U; i < count; i++)
+    {
+        frame[first + i] = Data[i];
+    }
+
+    primask = NVIC_EnterCritical();
+
+    if (tx->State != ISOTP_TX_IDLE)
+    {
+        retVal = ISOTP_BUSY;
+    }
+    else if (IsoTp_SendFrame(IsoTp_ChannelConfig[Channel].TxMsg, frame) == false)
+    {
+        /* Bulk queue full, nothing was sent */
+        retVal = ISOTP_BUSY;
+    }
+    else
+    {
+        tx->Data   = Data;
+        tx->Length = Length;
+        tx->Offset = count;
+
+        if (Length <= ISOTP_SF_MAX_DATA)
+        {
+            tx->State = ISOTP_TX_SF;
+        }
+        else
+        {
+            tx->State      = ISOTP_TX_FF;
+            tx->Sequence   = 1U;
+            tx->WaitCount  = 0U;
+            tx->FcDeferred = false;
+            tx->TimerMs    = ISOTP_TIMEOUT_MS;
+            IsoTp_TickStart();
+        }
+    }
+
+    NVIC_ExitCritical(primask);
+
+    return retVal;
+}
+
+/* End of a message accepted by MID_IsoTp_Send, called with interrupts masked.
+ * The Tx done callback is called by the caller once interrupts are restored. */
+static void IsoTp_TxEnd(uint8_t Channel, uint8_t Result)
+{
+    IsoTp_Tx[Channel].State = ISOTP_TX_IDLE;
+
+    if (Result == ISOTP_OK)
+    {
+        IsoTp_Stats.Sent++;
+    }
+    else
+    {
+        IsoTp_Stats.TxFailed++;
+    }
+}
+
+/* Queue the next consecutive frame, called with interrupts masked */
+static uint8_t IsoTp_TxNextFrame(uint8_t Channel)
+{
+    IsoTp_TxChannel_Typedef *tx = &IsoTp_Tx[Channel];
+    uint8_t  frame[ISOTP_FRAME_LENGTH];
+    uint16_t count = tx->Length - tx->Offset;
+    uint8_t  i     = 0U;
+
+    if (count > ISOTP_CF_MAX_DATA)
+    {
+        count = ISOTP_CF_MAX_DATA;
+    }
+
+    frame[0] = ISOTP_PCI_CF | tx->Sequence;
+    for (i = 0U; i < ISOTP_CF_MAX_DATA; i++)
+    {
+        frame[1U + i] = (i < count) ? tx->Data[tx->Offset + i] : ISOTP_PADDING;
+    }
+
+    /* One frame of the channel is pending at a time: frames of one ID in several mailboxes
+     * would leave in mailbox order, not in sequence order */
+    if (IsoTp_SendFrame(IsoTp_ChannelConfig[Channel].TxMsg, frame) == false)
+    {
+        IsoTp_TxEnd(Channel, ISOTP_ABORTED);
+        return ISOTP_ABORTED;
+    }
+
+    tx->Offset  += count;
+    tx->Sequence = (uint8_t)((tx->Sequence + 1U) & ISOTP_PCI_INFO_MASK);
+    tx->State    = ISOTP_TX_CF;
+
+    return ISOTP_PENDING;
+}
+
+/* First frame or last CF of a block confirmed, called with interrupts masked.
+ * A flow control that overtook the confirmation is acted on now. */
+static uint8_t IsoTp_TxWaitFlowControl(uint8_t Channel, bool FcDeferred)
+{
+    IsoTp_TxChannel_Typedef *tx = &IsoTp_Tx[Channel];
+
+    tx->State = ISOTP_TX_WAIT_FC;
+
+    if (FcDeferred == true)
+    {
+        return IsoTp_TxApplyFlowControl(Channel, tx->FcFrame);
+    }
+
+    tx->TimerMs = ISOTP_TIMEOUT_MS;
+    IsoTp_TickStart();
+
+    return ISOTP_PENDING;
+}
+
+void MID_IsoTp_OnTxConfirm(uint8_t Tx_Msg)
+{
+    IsoTp_TxChannel_Typedef *tx = NULL;
+    bool     deferred = false;
+    uint8_t  channel = 0U;
+    uint8_t  result  = ISOTP_PENDING;
+    uint32_t primask = 0U;
+
+    for (channel = 0U; (channel < ISOTP_CHANNEL_COUNT) && (IsoTp_ChannelConfig[channel].TxMsg != Tx_Msg); channel++)
+    {
+    }
+
+    if (channel == ISOTP_CHANNEL_COUNT)
+    {
+        return;
+    }
+
+    tx = &IsoTp_Tx[channel];
+
+    primask = NVIC_EnterCritical();
+
+    /* A deferred flow control only answers the frame confirmed now */
+    deferred = tx->FcDeferred;
+    tx->FcDeferred = false;
+
+    if (tx->State == ISOTP_TX_SF)
+    {
+        result = ISOTP_OK;
+        IsoTp_TxEnd(channel, result);
+    }
+    else if (tx->State == ISOTP_TX_FF)
+    {
+        result = IsoTp_TxWaitFlowControl(channel, deferred);
+    }
+    else if (tx->State == ISOTP_TX_CF)
+    {
+        if (tx->Offset >= tx->Length)
+        {
+            result = ISOTP_OK;
+            IsoTp_TxEnd(channel, result);
+        }
+        else if ((tx->BlockSize != 0U) && (++tx->BlockCount >= tx->BlockSize))
+        {
+            result = IsoTp_TxWaitFlowControl(channel, deferred);
+        }
+        else if (tx->StMinMs == 0U)
+        {
+            /* Back-to-back: the next frame is queued from the transmit complete interrupt */
+            result = IsoTp_TxNextFrame(channel);
+        }
+        else
+        {
+            tx->State   = ISOTP_TX_STMIN;
+            tx->TimerMs = tx->StMinMs;
+            IsoTp_TickStart();
+        }
+    }
+    else
+    {
+        /* Nothing of this channel pending */
+    }
+
+    NVIC_ExitCritical(primask);
+
+    if ((result != ISOTP_PENDING) && (IsoTp_TxDoneCallback != NULL))
+    {
+        IsoTp_TxDoneCallback(channel, result);
+    }
+}
+
+/* Flow control FS, BS and STmin, called with interrupts masked in ISOTP_TX_WAIT_FC */
+static uint8_t IsoTp_TxApplyFlowControl(uint8_t Channel, const uint8_t *FcFrame)
+{
+    IsoTp_TxChannel_Typedef *tx = &IsoTp_Tx[Channel];
+    uint8_t result = ISOTP_PENDING;
+
+    switch (FcFrame[0] & ISOTP_PCI_INFO_MASK)
+    {
+        case ISOTP_FC_CTS:
+            tx->BlockSize  = FcFrame[1];
+            tx->BlockCount = 0U;
+            tx->StMinMs    = IsoTp_StMinToMs(FcFrame[2]);
+            tx->WaitCount  = 0U;
+            result = IsoTp_TxNextFrame(Channel);
+            break;
+
+        case ISOTP_FC_WAIT:
+            if (++tx->WaitCount > ISOTP_WFT_MAX)
+            {
+                result = ISOTP_TIMEOUT;
+                IsoTp_TxEnd(Channel, result);
+            }
+            else
+            {
+                tx->TimerMs = ISOTP_TIMEOUT_MS;
+                IsoTp_TickStart();
+            }
+            break;
+
+        case ISOTP_FC_OVERFLOW:
+            result = ISOTP_OVERFLOW;
+            IsoTp_TxEnd(Channel, result);
+            break;
+
+        default:
+            result = ISOTP_ABORTED;
+            IsoTp_TxEnd(Channel, result);
+            break;
+    }
+
+    return result;
+}
+
+/* Flow control from the receiver, called with interrupts masked */
+static uint8_t IsoTp_TxFlowControl(uint8_t Channel, const Data_Typedef *Message)
+{
+    IsoTp_TxChannel_Typedef *tx = &IsoTp_Tx[Channel];
+    uint8_t i = 0U;
+
+    if (Message->DataLength < 3U)
+    {
+        return ISOTP_PENDING;
+    }
+
+    for (i = 0U; i < 3U; i++)
+    {
+        tx->FcFrame[i] = IsoTp_GetByte(Message, i);
+    }
+
+    if (tx->State == ISOTP_TX_WAIT_FC)
+    {
+        return IsoTp_TxApplyFlowControl(Channel, tx->FcFrame);
+    }
+
+    /* The CAN ISR handles received frames before transmit confirmations, the answer to the
+     * first frame or to the last CF of a block can come first. Queuing the next CF now would
+     * put two frames of the channel in flight and count the late confirmation as its own. */
+    if ((tx->State == ISOTP_TX_FF) || (tx->State == ISOTP_TX_CF))
+    {
+        tx->FcDeferred = true;
+    }
+
+    return ISOTP_PENDING;
+}
+
+/* Drop the reception in progress, called with interrupts masked */
+static void IsoTp_RxAbort(uint8_t Channel)
+{
+    if (IsoTp_Rx[Channel].Receiving == true)
+    {
+        IsoTp_Rx[Channel].Receiving = false;
+        IsoTp_Stats.RxFailed++;
+    }
+}
+
+/* Single frame, returns the message length or 0. Called with interrupts masked. */
+static uint16_t IsoTp_RxSingle(uint8_t Channel, const Data_Typedef *Message)
+{
+    IsoTp_RxChannel_Typedef *rx = &IsoTp_Rx[Channel];
+    uint8_t length = IsoTp_GetByte(Message, 0U) & ISOTP_PCI_INFO_MASK;
+    uint8_t i = 0U;
+
+    if ((length == 0U) || (length > ISOTP_SF_MAX_DATA) || (Message->DataLength < (length + 1U)))
+    {
+        return 0U;
+    }
+
+    /* A new message replaces the one in progress */
+    IsoTp_RxAbort(Channel);
+
+    for (i = 0U; i < length; i++)
+    {
+        rx->Buffer[i] = IsoTp_GetByte(Message, 1U + i);
+    }
+
+    IsoTp_Stats.Received++;
+
+    return length;
+}
+
+/* First frame, called with interrupts masked */
+static void IsoTp_RxFirst(uint8_t Channel, const Data_Typedef *Message)
+{
+    IsoTp_RxChannel_Typedef *rx = &IsoTp_Rx[Channel];
+    uint16_t length = ((uint16_t)(IsoTp_GetByte(Message, 0U) & ISOTP_PCI_INFO_MASK) << 8U) | IsoTp_GetByte(Message, 1U);
+    uint8_t i = 0U;
+
+    if ((length <= ISOTP_SF_MAX_DATA) || (Message->DataLength < ISOTP_FRAME_LENGTH))
+    {
+        return;
+    }
+
+    IsoTp_RxAbort(Channel);
+
+    if (length > ISOTP_RX_BUFFER_SIZE)
+    {
+        (void)IsoTp_SendFlowControl(Channel, ISOTP_FC_OVERFLOW);
+        IsoTp_Stats.RxFailed++;
+        return;
+    }
+
+    for (i = 0U; i < ISOTP_FF_DATA; i++)
+    {
+        rx->Buffer[i] = IsoTp_GetByte(Message, 2U + i);
+    }
+
+    rx->Length     = length;
+    rx->Offset     = ISOTP_FF_DATA;
+    rx->Sequence   = 1U;
+    rx->BlockCount = 0U;
+
+    if (IsoTp_SendFlowControl(Channel, ISOTP_FC_CTS) == true)
+    {
+        rx->Receiving = true;
+        rx->TimerMs   = ISOTP_TIMEOUT_MS;
+        IsoTp_TickStart();
+    }
+    else
+    {
+        IsoTp_Stats.RxFailed++;
+    }
+}
+
+/* Consecutive frame, returns the message length once complete or 0. Called with interrupts masked. */
+static uint16_t IsoTp_RxConsecutive(uint8_t Channel, const Data_Typedef *Message)
+{
+    IsoTp_RxChannel_Typedef *rx = &IsoTp_Rx[Channel];
+    uint16_t count = rx->Length - rx->Offset;
+    uint8_t i = 0U;
+
+    if (rx->Receiving == false)
+    {
+        return 0U;
+    }
+
+    if (count > ISOTP_CF_MAX_DATA)
+    {
+        count = ISOTP_CF_MAX_DATA;
+    }
+
+    if (((IsoTp_GetByte(Message, 0U) & ISOTP_PCI_INFO_MASK) != rx->Sequence) ||
+        (Message->DataLength < (count + 1U)))
+    {
+        IsoTp_RxAbort(Channel);
+        return 0U;
+    }
+
+    for (i = 0U; i < count; i++)
+    {
+        rx->Buffer[rx->Offset + i] = IsoTp_GetByte(Message, 1U + i);
+    }
+
+    rx->Offset  += count;
+    rx->Sequence = (uint8_t)((rx->Sequence + 1U) & ISOTP_PCI_INFO_MASK);
+    rx->TimerMs  = ISOTP_TIMEOUT_MS;
+
+    if (rx->Offset >= rx->Length)
+    {
+        rx->Receiving = false;
+        IsoTp_Stats.Received++;
+        return rx->Length;
+    }
+
+    if ((ISOTP_RX_BLOCK_SIZE != 0U) && (++rx->BlockCount >= ISOTP_RX_BLOCK_SIZE))
+    {
+        rx->BlockCount = 0U;
+
+        if (IsoTp_SendFlowControl(Channel, ISOTP_FC_CTS) == false)
+        {
+            IsoTp_RxAbort(Channel);
+        }
+    }
+
+    return 0U;
+}
+
+void MID_IsoTp_OnFrame(const Data_Typedef *Message)
+{
+    uint8_t  channel = IsoTp_FindChannelByRxId(Message->ID);
+    uint8_t  pci     = 0U;
+    uint8_t  result  = ISOTP_PENDING;
+    uint16_t length  = 0U;
+    uint32_t primask = 0U;
+
+    if ((channel == ISOTP_CHANNEL_COUNT) || (Message->DataLength == 0U))
+    {
+        return;
+    }
+
+    pci = IsoTp_GetByte(Message, 0U);
+
+    primask = NVIC_EnterCritical();
+
+    switch (pci & ISOTP_PCI_TYPE_MASK)
+    {
+        case ISOTP_PCI_SF:
+            length = IsoTp_RxSingle(channel, Message);
+            break;
+
+        case ISOTP_PCI_FF:
+            IsoTp_RxFirst(channel, Message);
+            break;
+
+        case ISOTP_PCI_CF:
+            length = IsoTp_RxConsecutive(channel, Message);
+            break;
+
+        case ISOTP_PCI_FC:
+            result = IsoTp_TxFlowControl(channel, Message);
+            break;
+
+        default:
+            /* Unknown frame type, ignored */
+            break;
+    }
+
+    NVIC_ExitCritical(primask);
+
+    /* The buffer is only written from the CAN ISR, it stays stable during the call */
+    if ((length != 0U) && (IsoTp_RxCallback != NULL))
+    {
+        IsoTp_RxCallback(channel, IsoTp_Rx[channel].Buffer, length);
+    }
+
+    if ((result != ISOTP_PENDING) && (IsoTp_TxDoneCallback != NULL))
+    {
+        IsoTp_TxDoneCallback(channel, result);
+    }
+}
+
+/* Timeouts and separation times, every ISOTP_TICK_MS while a transfer is in progress */
+static void IsoTp_Tick(void)
+{
+    IsoTp_TxChannel_Typedef *tx = NULL;
+    bool     active  = false;
+    uint8_t  channel = 0U;
+    uint8_t  result  = ISOTP_PENDING;
+    uint32_t primask = 0U;
+
+    for (channel = 0U; channel < ISOTP_CHANNEL_COUNT; channel++)
+    {
+        tx = &IsoTp_Tx[channel];
+        result = ISOTP_PENDING;
+
+        primask = NVIC_EnterCritical();
+
+        if (((tx->State == ISOTP_TX_FF) || (tx->State == ISOTP_TX_WAIT_FC) || (tx->State == ISOTP_TX_STMIN)) &&
+            (--tx->TimerMs == 0U))
+        {
+            if (tx->State != ISOTP_TX_STMIN)
+            {
+                result = ISOTP_TIMEOUT;
+                IsoTp_TxEnd(channel, result);
+            }
+            else
+            {
+                result = IsoTp_TxNextFrame(channel);
+            }
+        }
+
+        if ((IsoTp_Rx[channel].Receiving == true) && (--IsoTp_Rx[channel].TimerMs == 0U))
+        {
+            IsoTp_RxAbort(channel);
+        }
+
+        NVIC_ExitCritical(primask);
+
+        if ((result != ISOTP_PENDING) && (IsoTp_TxDoneCallback != NULL))
+        {
+            IsoTp_TxDoneCallback(channel, result);
+        }
+    }
+
+    primask = NVIC_EnterCritical();
+
+    for (channel = 0U; channel < ISOTP_CHANNEL_COUNT; channel++)
+    {
+        if ((IsoTp_Tx[channel].State == ISOTP_TX_FF) || (IsoTp_Tx[channel].State == ISOTP_TX_WAIT_FC) ||
+            (IsoTp_Tx[channel].State == ISOTP_TX_STMIN) || (IsoTp_Rx[channel].Receiving == true))
+        {
+            active = true;
+        }
+    }
+
+    /* Nothing left to time */
+    if (active == false)
+    {
+        MID_SwTimer_Stop(IsoTp_TimerId);
+        IsoTp_TickRunning = false;
+    }
+
+    NVIC_ExitCritical(primask);
+}
+
+void MID_IsoTp_RegisterRxCallback(void (*cb_ptr)(uint8_t Channel, const uint8_t *Data, uint16_t Length))
+{
+    IsoTp_RxCallback = cb_ptr;
+}
+
+void MID_IsoTp_RegisterTxDoneCallback(void (*cb_ptr)(uint8_t Channel, uint8_t Result))
+{
+    IsoTp_TxDoneCallback = cb_ptr;
+}
+
+void MID_IsoTp_GetStats(IsoTp_Stats_Typedef *stats)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    *stats = IsoTp_Stats;
+
+    NVIC_ExitCritical(primask);
+}
@@ -5,9 +5,12 @@
  *      Author: Ndhieu131020@gmail.com
 */
 
+#include <stdbool.h>
 #include "DRV_S32K144_ADC.h"
+#include "DRV_S32K144_NVIC.h"
 #include "DRV_S32K144_PORT.h"
 #include "MID_Sensor_Interface.h"
+#include "MID_Timer_Interface.h"
 
 /*******************************************************************************
  * Definition
@@ -25,13 +28,24 @@
 static void Pin_Init(void);
 static void ADC_Init(void);
 static uint16_t ConvertToRotation(uint16_t input);
+static uint8_t Sensor_StartConversion(void);
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
-static uint8_t  Sensor_State = IDLE;
+static volatile uint8_t Sensor_State = IDLE;
 static uint16_t ADC_Value    = 0U;
 
+/* Timestamp of the last trigger, in LPIT ticks */
+static uint32_t Trigger_Timestamp = 0U;
+
+/* Last value read and its sample time, answered to get-value requests */
+static bool     Latest_Valid     = false;
+static uint16_t Latest_Value     = 0U;
+static uint32_t Latest_Timestamp = 0U;
+
+static SensorStats_Typedef Sensor_Stats;
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -87,11 +101,25 @@ uint8_t MID_Get_DataSensorState(void)
 
 void MID_Set_DataSensorState(ReadFlag_Typedef State)
 {
+    uint32_t Latency_Us = 0U;
+
     Sensor_State = State;
 
     if(State == READY_TO_READ)
     {
         DRV_ADC_ClearITFlag(SENSOR_ADC, ADC_CHANNEL_IDX_0);
+
+        Latency_Us = MID_Timer_TicksToUs(MID_Timer_GetTimestamp() - Trigger_Timestamp);
+
+        if(Latency_Us > Sensor_Stats.WorstLatencyUs)
+        {
+            Sensor_Stats.WorstLatencyUs = Latency_Us;
+        }
+
+        if(Latency_Us > SENSOR_DEADLINE_US)
+        {
+            Sensor_Stats.LateConversionCount++;
+        }
     }
 }
 
@@ -103,20 +131,114 @@ static uint16_t ConvertToRotation(uint16_t input)
 uint16_t MID_Read_RotationValue(void)
 {
     uint16_t Sensor_Value = 0U;
+    uint32_t primask = 0U;
 
     ADC_Value = DRV_ADC_GetSoftTriggChannelResult(SENSOR_ADC);
 
     Sensor_Value = ConvertToRotation(ADC_Value);
 
+    /* Read from the ADC ISR and the main loop, answered from the CAN ISR */
+    primask = NVIC_EnterCritical();
+    Latest_Value     = Sensor_Value;
+    Latest_Timestamp = Trigger_Timestamp;
+    Latest_Valid     = true;
+    NVIC_ExitCritical(primask);
+
     return Sensor_Value;
 }
 
+/* Check and set of Sensor_State in one critical section: the timer ISR and the
+ * CAN Rx ISR both trigger. Returns the state found before the trigger. */
+static uint8_t Sensor_StartConversion(void)
+{
+    uint8_t  prevState = 0U;
+    uint32_t primask   = NVIC_EnterCritical();
+
+    prevState = Sensor_State;
+    if(prevState != BUSY)
+    {
+        Sensor_State = BUSY;
+        Trigger_Timestamp = MID_Timer_GetTimestamp();
+
+        DRV_ADC_SoftwareTriggerConversion(SENSOR_ADC, SENSOR_ADC_CHANNEL);
+    }
+
+    NVIC_ExitCritical(primask);
+
+    return prevState;
+}
+
 void MID_Trigger_ReadProcess(void)
 {
-    DRV_ADC_SoftwareTriggerConversion(SENSOR_ADC, SENSOR_ADC_CHANNEL);
+    uint8_t prevState = Sensor_StartConversion();
+
+    if(prevState == BUSY)
+    {
+        /* Retriggering would abort the running conversion */
+        Sensor_Stats.SkippedTriggerCount++;
+    }
+    else if(prevState == READY_TO_READ)
+    {
+        Sensor_Stats.OverrunCount++;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+bool MID_Trigger_RequestRead(void)
+{
+    /* On request, not on the sampling schedule: neither skipped nor an overrun */
+    return (Sensor_StartConversion() != BUSY);
 }
 
 void MID_ADC_RegisterNotificationCallback(void (*cb_ptr)(void))
 {
     ADC_RegisterIRQHandlerCallback(SENSOR_ADC, cb_ptr);
 }
+
+uint32_t MID_Sensor_GetSampleTimestamp(void)
+{
+    return Trigger_Timestamp;
+}
+
+bool MID_Sensor_GetLatestSample(uint16_t *Value, uint32_t *Timestamp)
+{
+    bool     retVal  = false;
+    uint32_t primask = NVIC_EnterCritical();
+
+    if (Latest_Valid == true)
+    {
+        *Value     = Latest_Value;
+        *Timestamp = Latest_Timestamp;
+        retVal = true;
+    }
+
+    NVIC_ExitCritical(primask);
+
+    return retVal;
+}
+
+bool MID_Sensor_TakeSample(uint16_t *Value)
+{
+    bool     retVal  = false;
+    uint32_t primask = NVIC_EnterCritical();
+
+    /* Check and clear in one critical section, a sample is taken once */
+    if (Sensor_State == READY_TO_READ)
+    {
+        Sensor_State = IDLE;
+        *Value = Latest_Value;
+        retVal = true;
+    }
+
+    NVIC_ExitCritical(primask);
+
+    return retVal;
+}
+
+void MID_Sensor_GetStats(SensorStats_Typedef *stats)
+{
+    *stats = Sensor_Stats;
+}
@@ -0,0 +1,168 @@
+/*
+ *  Filename: MID_TimeSync_Interface.c
+ *
+ *  Created on: 18-10-2026
+*/
+
+#include "DRV_S32K144_NVIC.h"
+#include "MID_Timer_Interface.h"
+#include "MID_TimeSync_Interface.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define PPB_PER_UNIT    (1000000000LL)
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static int64_t TSync_ElapsedUs(uint32_t From, uint32_t To);
+static uint32_t TSync_ToGlobal(uint32_t LocalTime);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static TimeSync_Status_Typedef TSync_Status;
+
+/* Reference point of the local clock: the last accepted SYNC in local and in master time */
+static uint32_t TSync_RefLocal = 0U;
+static uint32_t TSync_RefGlobalUs = 0U;
+
+/* SYNC waiting for its FOLLOW_UP */
+static bool     TSync_SyncPending = false;
+static uint32_t TSync_SyncRxTime = 0U;
+static uint8_t  TSync_Sequence = 0U;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/* Signed distance between two LPIT timestamps in us, valid within +-2^31 ticks */
+static int64_t TSync_ElapsedUs(uint32_t From, uint32_t To)
+{
+    int32_t diff = (int32_t)(To - From);
+
+    return (diff >= 0) ? (int64_t)MID_Timer_TicksToUs((uint32_t)diff) :
+                         -(int64_t)MID_Timer_TicksToUs((uint32_t)(-diff));
+}
+
+/* Corrected local clock, called with interrupts masked while synchronized */
+static uint32_t TSync_ToGlobal(uint32_t LocalTime)
+{
+    int64_t elapsedUs = TSync_ElapsedUs(TSync_RefLocal, LocalTime);
+
+    elapsedUs += (elapsedUs * TSync_Status.DriftPpb) / PPB_PER_UNIT;
+
+    return TSync_RefGlobalUs + (uint32_t)elapsedUs;
+}
+
+void MID_TimeSync_OnSync(uint8_t Sequence, uint32_t RxTime)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    /* The previous SYNC never got its FOLLOW_UP, or SYNCs were missed */
+    if ((TSync_SyncPending == true) ||
+        ((TSync_Status.Syncs != 0U) && (Sequence != (uint8_t)(TSync_Sequence + 1U))))
+    {
+        TSync_Status.Lost++;
+    }
+
+    TSync_Sequence    = Sequence;
+    TSync_SyncRxTime  = RxTime;
+    TSync_SyncPending = true;
+
+    NVIC_ExitCritical(primask);
+}
+
+void MID_TimeSync_OnFollowUp(uint32_t MasterTimeUs, uint32_t RxTime)
+{
+    int64_t  localElapsedUs  = 0;
+    int32_t  masterElapsedUs = 0;
+    int32_t  offsetUs        = 0;
+    int32_t  ratePpb         = 0;
+    uint32_t primask = NVIC_EnterCritical();
+
+    if ((TSync_SyncPending == true) &&
+        (TSync_ElapsedUs(TSync_SyncRxTime, RxTime) <= ((int64_t)TSYNC_FUP_TIMEOUT_MS * 1000)))
+    {
+        TSync_SyncPending = false;
+
+        if (TSync_Status.Synced == true)
+        {
+            localElapsedUs = TSync_ElapsedUs(TSync_RefLocal, TSync_SyncRxTime);
+            offsetUs = (int32_t)(MasterTimeUs - TSync_ToGlobal(TSync_SyncRxTime));
+
+            if ((localElapsedUs <= 0) || (localElapsedUs > ((int64_t)TSYNC_TIMEOUT_MS * 1000)) ||
+                (offsetUs > TSYNC_STEP_LIMIT_US) || (offsetUs < -TSYNC_STEP_LIMIT_US))
+            {
+                /* Master restarted, or the pairs are too far apart: start over from this pair */
+                TSync_Status.Synced = false;
+                TSync_Status.Resyncs++;
+            }
+            else
+            {
+                /* Rate error of the local oscillator over the last interval, low-pass filtered */
+                masterElapsedUs = (int32_t)(MasterTimeUs - TSync_RefGlobalUs);
+                ratePpb = (int32_t)((((int64_t)masterElapsedUs - localElapsedUs) * PPB_PER_UNIT) / localElapsedUs);
+                TSync_Status.DriftPpb += (ratePpb - TSync_Status.DriftPpb) / TSYNC_DRIFT_FILTER;
+
+                TSync_Status.LastOffsetUs = offsetUs;
+                offsetUs = (offsetUs < 0) ? -offsetUs : offsetUs;
+                if (offsetUs > TSync_Status.MaxOffsetUs)
+                {
+                    TSync_Status.MaxOffsetUs = offsetUs;
+                }
+            }
+        }
+
+        if (TSync_Status.Synced == false)
+        {
+            TSync_Status.DriftPpb     = 0;
+            TSync_Status.LastOffsetUs = 0;
+            TSync_Status.Synced       = true;
+        }
+
+        /* The offset is removed by moving the reference point onto the master time */
+        TSync_RefLocal    = TSync_SyncRxTime;
+        TSync_RefGlobalUs = MasterTimeUs;
+        TSync_Status.Syncs++;
+    }
+
+    NVIC_ExitCritical(primask);
+}
+
+bool MID_TimeSync_GetGlobalTime(uint32_t LocalTime, uint32_t *GlobalTimeUs)
+{
+    bool     retVal  = false;
+    uint32_t primask = NVIC_EnterCritical();
+
+    if ((TSync_Status.Synced == true) &&
+        (TSync_ElapsedUs(TSync_RefLocal, MID_Timer_GetTimestamp()) > ((int64_t)TSYNC_TIMEOUT_MS * 1000)))
+    {
+        /* No pair for too long, the drift estimate no longer holds */
+        TSync_Status.Synced = false;
+        TSync_Status.Resyncs++;
+    }
+
+    if (TSync_Status.Synced == true)
+    {
+        *GlobalTimeUs = TSync_ToGlobal(LocalTime);
+        retVal = true;
+    }
+
+    NVIC_ExitCritical(primask);
+
+    return retVal;
+}
+
+void MID_TimeSync_GetStatus(TimeSync_Status_Typedef *status)
+{
+    uint32_t primask = NVIC_EnterCritical();
+
+    *status = TSync_Status;
+
+    NVIC_ExitCritical(primask);
+}
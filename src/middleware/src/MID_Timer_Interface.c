@@ -8,27 +8,100 @@
 #include "DRV_S32K144_LPIT.h"
 #include "DRV_S32K144_ADC.h"
 #include "DRV_S32K144_MCU.h"
+#include "DRV_S32K144_NVIC.h"
 #include "MID_Timer_Interface.h"
 
 /*******************************************************************************
  * Definition
  ******************************************************************************/
-#define RELOAD_PERIOD_MS   100u
 #define MS_TO_SECOND       1000u
+#define US_TO_SECOND       1000000u
+
+#define SW_TIMER_WHEEL_MASK    (SW_TIMER_WHEEL_SIZE - 1U)
+
+#define SW_TIMER_DEADLINE_LPIT_CH    ((LPIT_ChannelTypedef)SW_TIMER_DEADLINE_CH)
+#define SW_TIMER_TIMEBASE_LPIT_CH    ((LPIT_ChannelTypedef)SW_TIMER_TIMEBASE_CH)
+
+/* Longest one-shot interval, keeps the time base sync well inside one wrap of the free-running channel */
+#define SW_TIMER_MAX_INTERVAL_RAW    (0x7FFFFFFFu)
+
+/* Virtual timer descriptor, linked into one slot of the timing wheel */
+typedef struct
+{
+    void (*Callback)(void);
+    SwTimer_Context Context;
+    uint32_t Expiry;      /* Absolute expiry tick */
+    uint32_t Period;      /* Reload in ticks, 0 for one-shot timers */
+    uint8_t  Next;
+    uint8_t  Prev;
+    bool     Used;
+    bool     Active;
+} SwTimer_Typedef;
 
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 
-void Timer_Notification(void);
+static void Timer_Notification(void);
+static void SwTimer_Init(uint32_t LPIT_Freq);
+static void SwTimer_Link(uint8_t TimerId);
+static void SwTimer_Unlink(uint8_t TimerId);
+static void SwTimer_Sync(void);
+static void SwTimer_ProgramDeadline(uint32_t Deadline);
+static void SwTimer_ProgramNext(void);
+static void SwTimer_DeadlineNotification(void);
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
+/* Number of LPIT ticks in one microsecond */
+static uint32_t Timer_TicksPerUs = 0u;
+
+/* Longest period MID_Timer_SetPeriodUs accepts, 0 when the LPIT clock is below 1 MHz */
+static uint32_t Timer_MaxPeriodUs = 0u;
+
+/* Application callback invoked on every period of channel 0 */
+static void (*Timer_UserCallback)(void) = NULL;
+
+static SwTimer_Typedef SwTimer_Pool[SW_TIMER_COUNT];
+
+/* Head timer id of each wheel slot */
+static uint8_t SwTimer_Wheel[SW_TIMER_WHEEL_SIZE];
+
+/* Monotonic tick count, advanced from the free-running channel by SwTimer_Sync() */
+static volatile uint32_t SwTimer_Ticks = 0u;
+
+/* Raw LPIT ticks not yet accounted in SwTimer_Ticks */
+static uint32_t SwTimer_Remainder = 0u;
+
+/* Elapsed raw LPIT ticks of the time base channel at the last sync */
+static uint32_t SwTimer_LastRaw = 0u;
+
+/* Last tick whose wheel slot has been processed */
+static uint32_t SwTimer_Processed = 0u;
+
+/* Tick programmed on the deadline channel */
+static uint32_t SwTimer_Deadline = 0u;
+
+/* Raw LPIT ticks in one software timer tick */
+static uint32_t SwTimer_RawPerTick = 0u;
+
+/* Expired timers whose callback is still to be run, one bit per timer id */
+static volatile uint32_t SwTimer_FiringMask  = 0u;
+static volatile uint32_t SwTimer_PendingMask = 0u;
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
+static void Timer_Notification(void)
+{
+    if (Timer_UserCallback != NULL)
+    {
+        Timer_UserCallback();
+    }
+}
+
 void MID_Timer_Init(void)
 {
     uint32_t reloadValue = 0u;
@@ -43,6 +116,7 @@ void MID_Timer_Init(void)
     LPIT_InitStructure.LPIT_ChainChannel = DISABLE;
     LPIT_InitStructure.LPIT_OperationMode = Periodic_Cnt_32b;
     LPIT_InitStructure.LPIT_Interupt = ENABLE;
+    LPIT_InitStructure.LPIT_OneShot = DISABLE;
 
     DRV_LPIT_Init(LPIT_INSTANCE, LPIT_CH0, &LPIT_InitStructure);
 
@@ -50,19 +124,27 @@ void MID_Timer_Init(void)
 
     if (LPIT_Freq != 0U)
     {
-        reloadValue = (LPIT_Freq * RELOAD_PERIOD_MS) / MS_TO_SECOND;
+        reloadValue = (LPIT_Freq * TIMER_SAMPLE_PERIOD_MS) / MS_TO_SECOND;
+        Timer_TicksPerUs = LPIT_Freq / US_TO_SECOND;
     }
     else
     {
         /* Error */
     }
 
+    /* Without a whole tick per microsecond no period can be set */
+    Timer_MaxPeriodUs = (Timer_TicksPerUs != 0u) ? (0xFFFFFFFFu / Timer_TicksPerUs) : 0u;
+
     DRV_LPIT_SetReloadValue(LPIT_INSTANCE, LPIT_CH0, reloadValue);
+
+    DRV_LPIT0_RegisterIntCallback(LPIT_CH0, &Timer_Notification);
+
+    SwTimer_Init(LPIT_Freq);
 }
 
 void MID_Timer_RegisterNotificationCallback(void (*cb_ptr)(void))
 {
-    DRV_LPIT0_RegisterIntCallback(LPIT_CH0, cb_ptr);
+    Timer_UserCallback = cb_ptr;
 }
 
 void MID_Timer_StartTimer(void)
@@ -72,5 +154,403 @@ void MID_Timer_StartTimer(void)
 
 void MID_Timer_StopTimer(void)
 {
+    /* The timestamp runs on the time base channel and keeps counting */
     DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, LPIT_CH0);
-}
\ No newline at end of file
+}
+
+bool MID_Timer_SetPeriodUs(uint32_t Period_Us)
+{
+    bool retVal = false;
+
+    if ((Period_Us != 0u) && (Period_Us <= Timer_MaxPeriodUs))
+    {
+        /* Loaded by the hardware at the next timeout, the running period completes unchanged */
+        DRV_LPIT_SetReloadValue(LPIT_INSTANCE, LPIT_CH0, Period_Us * Timer_TicksPerUs);
+
+        retVal = true;
+    }
+
+    return retVal;
+}
+
+uint32_t MID_Timer_GetTimestamp(void)
+{
+    /* Elapsed raw ticks of the free-running down counter, independent of the sampling channel */
+    return ~DRV_LPIT_GetCurrentTimerCount(LPIT_INSTANCE, SW_TIMER_TIMEBASE_LPIT_CH);
+}
+
+uint32_t MID_Timer_TicksToUs(uint32_t ticks)
+{
+    uint32_t retVal = 0u;
+
+    if (Timer_TicksPerUs != 0u)
+    {
+        retVal = ticks / Timer_TicksPerUs;
+    }
+
+    return retVal;
+}
+
+uint32_t MID_Timer_UsToTicks(uint32_t us)
+{
+    return us * Timer_TicksPerUs;
+}
+
+static void SwTimer_Init(uint32_t LPIT_Freq)
+{
+    uint8_t i = 0u;
+
+    LPIT_InitTypedef LPIT_InitStructure;
+
+    for (i = 0u; i < SW_TIMER_COUNT; i++)
+    {
+        SwTimer_Pool[i].Used   = false;
+        SwTimer_Pool[i].Active = false;
+    }
+
+    for (i = 0u; i < SW_TIMER_WHEEL_SIZE; i++)
+    {
+        SwTimer_Wheel[i] = SW_TIMER_INVALID_ID;
+    }
+
+    /* Scaled from the clock in Hz, not from whole ticks per us: a clock below 1 MHz keeps its
+     * tick length. Clamped so that an LPIT clock below one tick per SW_TIMER_TICK_US, or none,
+     * cannot make SwTimer_Sync and SwTimer_ProgramDeadline divide by zero. */
+    SwTimer_RawPerTick = LPIT_Freq / (US_TO_SECOND / SW_TIMER_TICK_US);
+    if (SwTimer_RawPerTick == 0u)
+    {
+        SwTimer_RawPerTick = 1u;
+    }
+
+    /* Time base: free-running down counter over the full 32-bit range, no interrupt */
+    DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, SW_TIMER_TIMEBASE_LPIT_CH);
+
+    LPIT_InitStructure.LPIT_ChainChannel = DISABLE;
+    LPIT_InitStructure.LPIT_OperationMode = Periodic_Cnt_32b;
+    LPIT_InitStructure.LPIT_Interupt = DISABLE;
+    LPIT_InitStructure.LPIT_OneShot = DISABLE;
+
+    DRV_LPIT_Init(LPIT_INSTANCE, SW_TIMER_TIMEBASE_LPIT_CH, &LPIT_InitStructure);
+    DRV_LPIT_SetReloadValue(LPIT_INSTANCE, SW_TIMER_TIMEBASE_LPIT_CH, 0u);    /* TVAL = 0xFFFFFFFF */
+
+    /* Deadline: one-shot, programmed for the next due timer only */
+    DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, SW_TIMER_DEADLINE_LPIT_CH);
+
+    LPIT_InitStructure.LPIT_Interupt = ENABLE;
+    LPIT_InitStructure.LPIT_OneShot = ENABLE;
+
+    DRV_LPIT_Init(LPIT_INSTANCE, SW_TIMER_DEADLINE_LPIT_CH, &LPIT_InitStructure);
+    DRV_LPIT0_RegisterIntCallback(SW_TIMER_DEADLINE_LPIT_CH, &SwTimer_DeadlineNotification);
+
+    DRV_LPIT_StartTimerChannel(LPIT_INSTANCE, SW_TIMER_TIMEBASE_LPIT_CH);
+    SwTimer_LastRaw = ~DRV_LPIT_GetCurrentTimerCount(LPIT_INSTANCE, SW_TIMER_TIMEBASE_LPIT_CH);
+
+    /* No timer yet: the keep-alive deadline only bounds the time between two syncs */
+    SwTimer_ProgramNext();
+}
+
+/* Insert at the head of the slot of its expiry tick, called with interrupts masked */
+static void SwTimer_Link(uint8_t TimerId)
+{
+    SwTimer_Typedef *Timer = &SwTimer_Pool[TimerId];
+    uint8_t Slot = (uint8_t)(Timer->Expiry & SW_TIMER_WHEEL_MASK);
+
+    Timer->Prev = SW_TIMER_INVALID_ID;
+    Timer->Next = SwTimer_Wheel[Slot];
+
+    if (Timer->Next != SW_TIMER_INVALID_ID)
+    {
+        SwTimer_Pool[Timer->Next].Prev = TimerId;
+    }
+
+    SwTimer_Wheel[Slot] = TimerId;
+    Timer->Active = true;
+}
+
+/* Remove from its wheel slot, called with interrupts masked */
+static void SwTimer_Unlink(uint8_t TimerId)
+{
+    SwTimer_Typedef *Timer = &SwTimer_Pool[TimerId];
+
+    if (Timer->Prev != SW_TIMER_INVALID_ID)
+    {
+        SwTimer_Pool[Timer->Prev].Next = Timer->Next;
+    }
+    else
+    {
+        SwTimer_Wheel[Timer->Expiry & SW_TIMER_WHEEL_MASK] = Timer->Next;
+    }
+
+    if (Timer->Next != SW_TIMER_INVALID_ID)
+    {
+        SwTimer_Pool[Timer->Next].Prev = Timer->Prev;
+    }
+
+    Timer->Active = false;
+}
+
+/* Advance SwTimer_Ticks from the free-running channel, called with interrupts masked.
+ * The deadline channel is never read back, so reprogramming it cannot make time drift. */
+static void SwTimer_Sync(void)
+{
+    uint32_t Raw   = ~DRV_LPIT_GetCurrentTimerCount(LPIT_INSTANCE, SW_TIMER_TIMEBASE_LPIT_CH);
+    uint32_t Delta = (Raw - SwTimer_LastRaw) + SwTimer_Remainder;
+
+    SwTimer_LastRaw    = Raw;
+    SwTimer_Ticks     += Delta / SwTimer_RawPerTick;
+    SwTimer_Remainder  = Delta % SwTimer_RawPerTick;
+}
+
+/* Program the one-shot channel to expire on the boundary of tick Deadline, called with interrupts masked */
+static void SwTimer_ProgramDeadline(uint32_t Deadline)
+{
+    uint32_t Interval = Deadline - SwTimer_Ticks;
+    uint32_t Raw      = 0u;
+
+    if ((int32_t)Interval <= 0)
+    {
+        Interval = 1u;
+    }
+
+    if (Interval > (SW_TIMER_MAX_INTERVAL_RAW / SwTimer_RawPerTick))
+    {
+        Interval = SW_TIMER_MAX_INTERVAL_RAW / SwTimer_RawPerTick;
+    }
+
+    /* Land on the tick boundary of the time base, not one full tick from now */
+    Raw = (Interval * SwTimer_RawPerTick) - SwTimer_Remainder;
+
+    SwTimer_Deadline = SwTimer_Ticks + Interval;
+
+    DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, SW_TIMER_DEADLINE_LPIT_CH);
+    DRV_LPIT_ClearInterruptFlagTimerChannels(LPIT_INSTANCE, SW_TIMER_DEADLINE_LPIT_CH);
+    DRV_LPIT_SetReloadValue(LPIT_INSTANCE, SW_TIMER_DEADLINE_LPIT_CH, Raw);
+    DRV_LPIT_StartTimerChannel(LPIT_INSTANCE, SW_TIMER_DEADLINE_LPIT_CH);
+}
+
+/* Program the earliest expiry, coalesced with the expiries that follow it
+ * within SW_TIMER_COALESCE_TICKS. Called with interrupts masked. */
+static void SwTimer_ProgramNext(void)
+{
+    uint32_t Earliest = 0u;
+    uint32_t Deadline = 0u;
+    bool     Found    = false;
+    uint8_t  i        = 0u;
+
+    for (i = 0u; i < SW_TIMER_COUNT; i++)
+    {
+        if ((SwTimer_Pool[i].Active == true) && \
+            ((Found == false) || ((int32_t)(SwTimer_Pool[i].Expiry - Earliest) < 0)))
+        {
+            Earliest = SwTimer_Pool[i].Expiry;
+            Found = true;
+        }
+    }
+
+    Deadline = Earliest;
+
+    for (i = 0u; (i < SW_TIMER_COUNT) && (Found == true); i++)
+    {
+        if ((SwTimer_Pool[i].Active == true) && \
+            ((int32_t)(SwTimer_Pool[i].Expiry - Deadline) > 0) && \
+            ((SwTimer_Pool[i].Expiry - Earliest) <= SW_TIMER_COALESCE_TICKS))
+        {
+            Deadline = SwTimer_Pool[i].Expiry;
+        }
+    }
+
+    if (Found == false)
+    {
+        Deadline = SwTimer_Ticks + (SW_TIMER_MAX_INTERVAL_RAW / SwTimer_RawPerTick);
+    }
+
+    SwTimer_ProgramDeadline(Deadline);
+}
+
+static void SwTimer_DeadlineNotification(void)
+{
+    uint32_t primask = 0u;
+    uint32_t Slots   = 0u;
+    uint32_t Tick    = 0u;
+    uint8_t  TimerId = SW_TIMER_INVALID_ID;
+    uint8_t  NextId  = SW_TIMER_INVALID_ID;
+
+    primask = NVIC_EnterCritical();
+
+    SwTimer_Sync();
+
+    /* Visit every slot passed since the last expiry, at most one revolution */
+    Slots = SwTimer_Ticks - SwTimer_Processed;
+    if (Slots > SW_TIMER_WHEEL_SIZE)
+    {
+        Slots = SW_TIMER_WHEEL_SIZE;
+    }
+
+    for (Tick = SwTimer_Ticks - Slots + 1u; Slots > 0u; Slots--, Tick++)
+    {
+        TimerId = SwTimer_Wheel[Tick & SW_TIMER_WHEEL_MASK];
+        while (TimerId != SW_TIMER_INVALID_ID)
+        {
+            NextId = SwTimer_Pool[TimerId].Next;
+
+            /* Timers of later rounds stay linked */
+            if ((int32_t)(SwTimer_Pool[TimerId].Expiry - SwTimer_Ticks) <= 0)
+            {
+                SwTimer_Unlink(TimerId);
+
+                if (SwTimer_Pool[TimerId].Period != 0u)
+                {
+                    SwTimer_Pool[TimerId].Expiry += SwTimer_Pool[TimerId].Period;
+
+                    /* Skip the periods missed while late, keeping the phase otherwise */
+                    if ((int32_t)(SwTimer_Pool[TimerId].Expiry - SwTimer_Ticks) <= 0)
+                    {
+                        SwTimer_Pool[TimerId].Expiry = SwTimer_Ticks + SwTimer_Pool[TimerId].Period;
+                    }
+
+                    SwTimer_Link(TimerId);
+                }
+
+                if (SwTimer_Pool[TimerId].Context == SW_TIMER_CONTEXT_ISR)
+                {
+                    SwTimer_FiringMask |= (1UL << TimerId);
+                }
+                else
+                {
+                    SwTimer_PendingMask |= (1UL << TimerId);
+                }
+            }
+
+            TimerId = NextId;
+        }
+    }
+
+    SwTimer_Processed = SwTimer_Ticks;
+
+    SwTimer_ProgramNext();
+
+    NVIC_ExitCritical(primask);
+
+    /* Callbacks may start or stop any timer, including the ones still to fire */
+    while (SwTimer_FiringMask != 0u)
+    {
+        primask = NVIC_EnterCritical();
+        TimerId = (uint8_t)__builtin_ctz(SwTimer_FiringMask);
+        SwTimer_FiringMask &= ~(1UL << TimerId);
+        NVIC_ExitCritical(primask);
+
+        SwTimer_Pool[TimerId].Callback();
+    }
+}
+
+uint8_t MID_SwTimer_Create(void (*cb_ptr)(void), SwTimer_Context Context)
+{
+    uint32_t primask = 0u;
+    uint8_t  retVal  = SW_TIMER_INVALID_ID;
+    uint8_t  i       = 0u;
+
+    if (cb_ptr != NULL)
+    {
+        primask = NVIC_EnterCritical();
+
+        for (i = 0u; (i < SW_TIMER_COUNT) && (retVal == SW_TIMER_INVALID_ID); i++)
+        {
+            if (SwTimer_Pool[i].Used == false)
+            {
+                SwTimer_Pool[i].Used     = true;
+                SwTimer_Pool[i].Active   = false;
+                SwTimer_Pool[i].Callback = cb_ptr;
+                SwTimer_Pool[i].Context  = Context;
+                retVal = i;
+            }
+        }
+
+        NVIC_ExitCritical(primask);
+    }
+
+    return retVal;
+}
+
+void MID_SwTimer_Start(uint8_t TimerId, uint32_t Timeout_Ms, SwTimer_Mode Mode)
+{
+    uint32_t primask = 0u;
+    uint32_t Ticks   = (Timeout_Ms * 1000u) / SW_TIMER_TICK_US;
+
+    if ((TimerId < SW_TIMER_COUNT) && (SwTimer_Pool[TimerId].Used == true))
+    {
+        if (Ticks == 0u)
+        {
+            Ticks = 1u;
+        }
+
+        primask = NVIC_EnterCritical();
+
+        if (SwTimer_Pool[TimerId].Active == true)
+        {
+            SwTimer_Unlink(TimerId);
+        }
+
+        SwTimer_Sync();
+
+        SwTimer_Pool[TimerId].Expiry = SwTimer_Ticks + Ticks;
+        SwTimer_Pool[TimerId].Period = (Mode == SW_TIMER_PERIODIC) ? Ticks : 0u;
+        SwTimer_Link(TimerId);
+
+        /* Only a new earliest deadline reprograms the channel */
+        if ((int32_t)(SwTimer_Pool[TimerId].Expiry - SwTimer_Deadline) < 0)
+        {
+            SwTimer_ProgramDeadline(SwTimer_Pool[TimerId].Expiry);
+        }
+
+        NVIC_ExitCritical(primask);
+    }
+}
+
+void MID_SwTimer_Stop(uint8_t TimerId)
+{
+    uint32_t primask = 0u;
+
+    if ((TimerId < SW_TIMER_COUNT) && (SwTimer_Pool[TimerId].Used == true))
+    {
+        primask = NVIC_EnterCritical();
+
+        if (SwTimer_Pool[TimerId].Active == true)
+        {
+            SwTimer_Unlink(TimerId);
+        }
+
+        SwTimer_FiringMask  &= ~(1UL << TimerId);
+        SwTimer_PendingMask &= ~(1UL << TimerId);
+
+        NVIC_ExitCritical(primask);
+    }
+}
+
+void MID_SwTimer_Process(void)
+{
+    uint32_t primask = 0u;
+    uint8_t  TimerId = SW_TIMER_INVALID_ID;
+
+    while (SwTimer_PendingMask != 0u)
+    {
+        primask = NVIC_EnterCritical();
+        TimerId = (uint8_t)__builtin_ctz(SwTimer_PendingMask);
+        SwTimer_PendingMask &= ~(1UL << TimerId);
+        NVIC_ExitCritical(primask);
+
+        SwTimer_Pool[TimerId].Callback();
+    }
+}
+
+uint32_t MID_SwTimer_GetTicks(void)
+{
+    uint32_t primask = 0u;
+    uint32_t retVal  = 0u;
+
+    primask = NVIC_EnterCritical();
+    SwTimer_Sync();
+    retVal = SwTimer_Ticks;
+    NVIC_ExitCritical(primask);
+
+    return retVal;
+}
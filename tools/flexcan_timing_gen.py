@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+#  Filename: flexcan_timing_gen.py
+#
+#  Host tool: generates src/drivers/inc/DRV_S32K144_FLEXCAN_TimingTable.h, the
+#  const bit-timing table looked up by DRV_FLEXCAN_Init before it falls back to
+#  the runtime search of FLEXCAN_BitrateToTimeSeg.
+#
+#  The search below mirrors FLEXCAN_BitrateToTimeSeg step by step, so a table
+#  entry is exactly what the driver would compute at init. Only combinations
+#  with an exact bitrate and a sample point within 1 % are emitted, every entry
+#  is checked against the CTRL1 field limits.
+#
+#  Usage: python3 tools/flexcan_timing_gen.py > src/drivers/inc/DRV_S32K144_FLEXCAN_TimingTable.h
+#
+
+CLOCKS_HZ = [8000000, 40000000, 48000000, 80000000]
+BITRATES = [125000, 250000, 500000, 1000000]
+SAMPLE_POINTS = [75, 80, 87]
+
+PRESDIV_MAX = 255
+NUM_TQ_MIN, NUM_TQ_MAX = 8, 25
+TSEG1_MIN, TSEG1_MAX = 2, 16
+TSEG2_MIN, TSEG2_MAX = 2, 8
+PROPSEG_MAX = 7
+PSEG1_MAX = 7
+PSEG2_MIN, PSEG2_MAX = 1, 7
+RJW_MAX = 3
+
+
+def bitrate_to_time_seg(bitrate, clk, sample_point):
+    """Mirror of FLEXCAN_BitrateToTimeSeg, returns (segments, dBitrate, dSample, steps)."""
+    d_bitrate_min, d_sample_min = 1000000, 100
+    best = (0, 0, 0, 0)
+    steps = 0
+    exit_flag = True
+    presdiv = 0
+    while presdiv <= PRESDIV_MAX and exit_flag:
+        steps += 1
+        num_tq = clk // (bitrate * (presdiv + 1))
+        if NUM_TQ_MIN <= num_tq <= NUM_TQ_MAX:
+            tmp_bitrate = clk // (num_tq * (presdiv + 1))
+            tseg1 = (num_tq * sample_point // 100) - 1
+            tseg2 = num_tq - tseg1 - 1
+            while tseg1 > TSEG1_MAX or tseg2 < TSEG2_MIN:
+                tseg1 -= 1
+                tseg2 += 1
+            pseg2 = tseg2 - 1
+            pseg1 = pseg2
+            prop = tseg1 - pseg1 - 2
+            while prop <= 0 and pseg1 > 0:
+                prop += 1
+                pseg1 -= 1
+            while prop > PROPSEG_MAX:
+                prop -= 1
+                pseg1 += 1
+            valid = not (tseg1 > TSEG1_MAX or tseg1 < TSEG1_MIN or tseg2 > TSEG2_MAX or
+                         tseg2 < TSEG2_MIN or prop <= 0 or prop > PROPSEG_MAX or
+                         pseg1 > PSEG1_MAX or pseg2 > PSEG2_MAX or pseg2 < PSEG2_MIN)
+            if valid:
+                tmp_sample = ((tseg1 + 1) * 100) // num_tq
+                d_sample = abs(tmp_sample - sample_point)
+                d_bitrate = abs(tmp_bitrate - bitrate)
+                if d_bitrate < d_bitrate_min or (d_bitrate == d_bitrate_min and d_sample < d_sample_min):
+                    d_bitrate_min, d_sample_min = d_bitrate, d_sample
+                    best = (presdiv, prop, pseg1, pseg2)
+                    if d_bitrate == 0 and d_sample <= 1:
+                        exit_flag = False
+        presdiv += 1
+    return best, d_bitrate_min, d_sample_min, steps
+
+
+def check(bitrate, clk, sample_point, seg):
+    presdiv, prop, pseg1, pseg2 = seg
+    num_tq = 1 + (prop + 1) + (pseg1 + 1) + (pseg2 + 1)
+    assert presdiv <= PRESDIV_MAX
+    assert 1 <= prop <= PROPSEG_MAX and pseg1 <= PSEG1_MAX and PSEG2_MIN <= pseg2 <= PSEG2_MAX
+    assert NUM_TQ_MIN <= num_tq <= NUM_TQ_MAX
+    assert clk == bitrate * num_tq * (presdiv + 1)
+    actual_sp = (num_tq - (pseg2 + 1)) * 100 // num_tq
+    assert abs(actual_sp - sample_point) <= 1
+    return num_tq, actual_sp
+
+
+def main():
+    rows = []
+    for clk in CLOCKS_HZ:
+        for bitrate in BITRATES:
+            for sp in SAMPLE_POINTS:
+                seg, d_bitrate, d_sample, steps = bitrate_to_time_seg(bitrate, clk, sp)
+                if d_bitrate != 0 or d_sample > 1:
+                    continue
+                num_tq, actual_sp = check(bitrate, clk, sp, seg)
+                rows.append((clk, bitrate, sp, seg, num_tq, actual_sp, steps))
+
+    print("/*")
+    print(" *  Filename: DRV_S32K144_FLEXCAN_TimingTable.h")
+    print(" *")
+    print(" *  Generated by tools/flexcan_timing_gen.py, do not edit.")
+    print(" *  Included by DRV_S32K144_FLEXCAN.c only.")
+    print("*/")
+    print()
+    print("#ifndef DRV_S32K144_FLEXCAN_TIMINGTABLE_H_")
+    print("#define DRV_S32K144_FLEXCAN_TIMINGTABLE_H_")
+    print()
+    print("/* { clock Hz, bitrate, sample point %, { presDiv, rJumpWidth, propSeg, phaseSeg1, phaseSeg2 } }")
+    print(" * Comment: time quanta per bit, resulting sample point, prescaler steps of the runtime search */")
+    print("static const flexcan_timing_entry_t g_flexcanTimingTable[] =")
+    print("{")
+    for i, (clk, bitrate, sp, seg, num_tq, actual_sp, steps) in enumerate(rows):
+        presdiv, prop, pseg1, pseg2 = seg
+        rjw = pseg1 if pseg1 < RJW_MAX else RJW_MAX
+        sep = "," if i < len(rows) - 1 else " "
+        print("    {%9uU, %7uU, %2uU, {%3uU, %uU, %uU, %uU, %uU}}%s /* %2u tq, %2u %%, %3u steps */"
+              % (clk, bitrate, sp, presdiv, rjw, prop, pseg1, pseg2, sep, num_tq, actual_sp, steps))
+    print("};")
+    print()
+    print("#endif /* DRV_S32K144_FLEXCAN_TIMINGTABLE_H_ */")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,728 @@
+/*
+ *  Filename: boot_bench.c
+ *
+ *  Host harness: runs src/middleware/src/MID_Boot_Interface.c unchanged against a
+ *  simulated P-Flash and CAN bus and reports the update throughput in bytes per second.
+ *
+ *  One clock drives everything. A flash command advances it by its modelled duration
+ *  with the CAN ISR masked, frames completed meanwhile wait in the Rx FIFO until the
+ *  command is done, as on the target. The master sends START, the blocks and FINISH
+ *  over ISO-TP with the flow control of the node (ISOTP_RX_BLOCK_SIZE), keeping up to
+ *  Window requests in flight. Afterwards the slot must hold the image and
+ *  MID_Boot_StartImage must jump to it.
+ *
+ *  Usage: make -C tools/host run
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "DRV_S32K144_FTFC.h"
+#include "DRV_S32K144_NVIC.h"
+#include "system_S32K144.h"
+#include "MID_Timer_Interface.h"
+#include "MID_IsoTp_Interface.h"
+#include "MID_Boot_Interface.h"
+
+/* Flash timing, typical values of the S32K1xx data sheet. Program Section is modelled
+ * as its phrases at the Program Phrase time. Override with -D */
+#ifndef BENCH_ERASE_US
+#define BENCH_ERASE_US          (12000u)    /* Erase Flash Sector                            */
+#endif
+#ifndef BENCH_PHRASE_US
+#define BENCH_PHRASE_US         (36u)       /* Program Phrase                                */
+#endif
+#ifndef BENCH_ERASE_SLICE_US
+#define BENCH_ERASE_SLICE_US    (1000u)     /* FTFC_ERASE_SLICE_POLLS polls, ISR served after */
+#endif
+
+/* Node CPU, 80 MHz core */
+#define BENCH_LOOP_US           (2u)        /* Main loop turn without flash command          */
+#define BENCH_CRC_NS_PER_BYTE   (300u)      /* Nibble table CRC-32 from flash                */
+
+/* 8-byte standard frame with average stuffing and intermission */
+#define BENCH_FRAME_BITS        (125u)
+
+#define BENCH_QUEUE_SIZE        (16u)
+
+typedef struct
+{
+    uint8_t Data[8];
+    bool    ToNode;
+} Bench_Frame;
+
+/* Node events masked by a flash command */
+typedef struct
+{
+    Bench_Frame Frame;
+    bool        TxDone;
+} Bench_Event;
+
+typedef struct
+{
+    uint32_t Bitrate;
+    uint32_t Window;
+    uint32_t ImageSize;
+} Bench_Scenario;
+
+/*******************************************************************************
+ * Simulated target
+ ******************************************************************************/
+
+static uint8_t  Sim_Flash[FTFC_PFLASH_SIZE];
+static uint64_t Sim_Now = 0u;           /* us */
+static uint64_t Sim_FlashBusyUs = 0u;
+static uint32_t Sim_Jumps = 0u;
+static uint32_t Sim_JumpTarget = 0u;
+
+uint32_t __VECTOR_TABLE[1];
+
+/* Bus */
+static uint32_t    Bus_FrameUs = 0u;
+static bool        Bus_Busy = false;
+static uint64_t    Bus_End = 0u;
+static Bench_Frame Bus_Frame;
+
+static Bench_Frame Node_TxQueue[BENCH_QUEUE_SIZE];
+static uint32_t    Node_TxHead = 0u;
+static uint32_t    Node_TxCount = 0u;
+static Bench_Event Node_Pending[BENCH_QUEUE_SIZE];
+static uint32_t    Node_PendingCount = 0u;
+static uint32_t    Node_PendingMax = 0u;
+
+/* Node ISO-TP receiver, channel BOOT_ISOTP_CHANNEL */
+static uint8_t  NodeRx_Buffer[ISOTP_RX_BUFFER_SIZE];
+static uint32_t NodeRx_Length = 0u;
+static uint32_t NodeRx_Offset = 0u;
+static uint32_t NodeRx_BlockCount = 0u;
+
+/* Master */
+static const uint8_t *Master_Image = NULL;
+static uint32_t Master_ImageSize = 0u;
+static uint32_t Master_Window = 0u;
+static uint32_t Master_BlockCount = 0u;
+static uint32_t Master_Next = 0u;       /* Request being or to be sent: 0 START, 1..N blocks, N + 1 FINISH */
+static uint32_t Master_Acked = 0u;
+static bool     Master_Sending = false;
+static bool     Master_FrameReady = false;
+static bool     Master_WaitFc = false;
+static Bench_Frame Master_Frame;
+static uint8_t  Master_Msg[BOOT_BLOCK_SIZE + 3u];
+static uint32_t Master_MsgLength = 0u;
+static uint32_t Master_MsgOffset = 0u;
+static uint32_t Master_Sn = 0u;
+static uint32_t Master_CfLeft = 0u;
+static uint64_t Master_DoneUs = 0u;
+static bool     Master_Done = false;
+
+static uint32_t Bench_VerifyLeft = 0u;
+
+static void Bus_RunUntil(uint64_t t, bool isrOn);
+static void Node_ServicePending(void);
+static void Master_Pump(void);
+
+static uint32_t Bench_Crc32(const uint8_t *Data, uint32_t Length)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    uint32_t i = 0u;
+    uint32_t b = 0u;
+
+    for (i = 0u; i < Length; i++)
+    {
+        crc ^= Data[i];
+        for (b = 0u; b < 8u; b++)
+        {
+            crc = (crc >> 1u) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+const uint8_t *Sim_FlashPtr(uint32_t address)
+{
+    if (address >= FTFC_PFLASH_SIZE)
+    {
+        fprintf(stderr, "flash read outside the P-Flash: 0x%08X\n", (unsigned)address);
+        exit(1);
+    }
+
+    return &Sim_Flash[address];
+}
+
+/* Runs a flash command of Us microseconds, the CAN ISR masked */
+static void Sim_FlashCommand(uint32_t Us)
+{
+    Sim_FlashBusyUs += Us;
+    Bus_RunUntil(Sim_Now + Us, false);
+    Node_ServicePending();
+}
+
+ftfc_status_t DRV_FTFC_EraseSector(uint32_t address)
+{
+    uint32_t left = BENCH_ERASE_US;
+    uint32_t slice = 0u;
+
+    if (((address % FTFC_SECTOR_SIZE) != 0u) || (address >= FTFC_PFLASH_SIZE))
+    {
+        return FTFC_STATUS_INVALID_PARAM;
+    }
+
+    /* Suspended in slices, interrupts served in between */
+    while (left > 0u)
+    {
+        slice = (left > BENCH_ERASE_SLICE_US) ? BENCH_ERASE_SLICE_US : left;
+        Sim_FlashCommand(slice);
+        left -= slice;
+    }
+
+    memset(&Sim_Flash[address], 0xFF, FTFC_SECTOR_SIZE);
+
+    return FTFC_STATUS_SUCCESS;
+}
+
+static ftfc_status_t Sim_Program(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    uint32_t i = 0u;
+
+    if (((address % FTFC_PHRASE_SIZE) != 0u) || ((length % FTFC_PHRASE_SIZE) != 0u) ||
+        (length == 0u) || ((address + length) > FTFC_PFLASH_SIZE))
+    {
+        return FTFC_STATUS_INVALID_PARAM;
+    }
+
+    /* Programming a phrase twice is an access error */
+    for (i = 0u; i < length; i++)
+    {
+        if (Sim_Flash[address + i] != 0xFFu)
+        {
+            return FTFC_STATUS_ACCESS_ERROR;
+        }
+    }
+
+    Sim_FlashCommand((length / FTFC_PHRASE_SIZE) * BENCH_PHRASE_US);
+    memcpy(&Sim_Flash[address], data, length);
+
+    return FTFC_STATUS_SUCCESS;
+}
+
+ftfc_status_t DRV_FTFC_ProgramPhrase(uint32_t address, const uint8_t *data)
+{
+    return Sim_Program(address, data, FTFC_PHRASE_SIZE);
+}
+
+ftfc_status_t DRV_FTFC_ProgramSection(uint32_t address, const uint8_t *data, uint16_t length)
+{
+    if (length > FTFC_SECTION_MAX_SIZE)
+    {
+        return FTFC_STATUS_INVALID_PARAM;
+    }
+
+    return Sim_Program(address, data, length);
+}
+
+uint32_t NVIC_EnterCritical(void)
+{
+    return 0u;
+}
+
+void NVIC_ExitCritical(uint32_t primask)
+{
+    (void)primask;
+}
+
+void NVIC_JumpToImage(uint32_t vectorTable)
+{
+    Sim_Jumps++;
+    Sim_JumpTarget = vectorTable;
+}
+
+void SystemSoftwareReset(void)
+{
+    fprintf(stderr, "unexpected reset\n");
+    exit(1);
+}
+
+/* The timestamp counts microseconds */
+uint32_t MID_Timer_GetTimestamp(void)
+{
+    return (uint32_t)Sim_Now;
+}
+
+uint32_t MID_Timer_TicksToUs(uint32_t ticks)
+{
+    return ticks;
+}
+
+/* Node responses are single frames */
+uint8_t MID_IsoTp_Send(uint8_t Channel, const uint8_t *Data, uint16_t Length)
+{
+    Bench_Frame *frame = NULL;
+
+    if ((Channel != BOOT_ISOTP_CHANNEL) || (Length == 0u) || (Length > 7u))
+    {
+        return ISOTP_INVALID;
+    }
+    if (Node_TxCount == BENCH_QUEUE_SIZE)
+    {
+        return ISOTP_BUSY;
+    }
+
+    frame = &Node_TxQueue[(Node_TxHead + Node_TxCount) % BENCH_QUEUE_SIZE];
+    memset(frame->Data, ISOTP_PADDING, sizeof(frame->Data));
+    frame->Data[0] = (uint8_t)Length;
+    memcpy(&frame->Data[1], Data, Length);
+    frame->ToNode = false;
+    Node_TxCount++;
+
+    return ISOTP_OK;
+}
+
+/*******************************************************************************
+ * Node ISR
+ ******************************************************************************/
+
+static void Node_SendFlowControl(void)
+{
+    Bench_Frame *frame = &Node_TxQueue[(Node_TxHead + Node_TxCount) % BENCH_QUEUE_SIZE];
+
+    memset(frame->Data, ISOTP_PADDING, sizeof(frame->Data));
+    frame->Data[0] = 0x30u;
+    frame->Data[1] = ISOTP_RX_BLOCK_SIZE;
+    frame->Data[2] = ISOTP_RX_STMIN;
+    frame->ToNode  = false;
+    Node_TxCount++;
+}
+
+static void Node_Isr(const Bench_Event *event)
+{
+    const uint8_t *data = event->Frame.Data;
+    uint32_t count = 0u;
+
+    if (event->TxDone == true)
+    {
+        /* Flow control frames need no confirmation */
+        if ((event->Frame.Data[0] >> 4u) == 0u)
+        {
+            MID_Boot_OnTxDone();
+        }
+        return;
+    }
+
+    switch (data[0] >> 4u)
+    {
+        case 0u:
+            MID_Boot_OnRequest(&data[1], (uint16_t)(data[0] & 0x0Fu));
+            break;
+
+        case 1u:
+            NodeRx_Length     = ((uint32_t)(data[0] & 0x0Fu) << 8u) | data[1];
+            memcpy(NodeRx_Buffer, &data[2], 6u);
+            NodeRx_Offset     = 6u;
+            NodeRx_BlockCount = 0u;
+            Node_SendFlowControl();
+            break;
+
+        case 2u:
+            count = NodeRx_Length - NodeRx_Offset;
+            if (count > 7u)
+            {
+                count = 7u;
+            }
+            memcpy(&NodeRx_Buffer[NodeRx_Offset], &data[1], count);
+            NodeRx_Offset += count;
+            if (NodeRx_Offset >= NodeRx_Length)
+            {
+                MID_Boot_OnRequest(NodeRx_Buffer, (uint16_t)NodeRx_Length);
+                if (NodeRx_Buffer[0] == BOOT_SERVICE_FINISH)
+                {
+                    Bench_VerifyLeft = Master_ImageSize;
+                }
+            }
+            else if ((ISOTP_RX_BLOCK_SIZE != 0u) && (++NodeRx_BlockCount == ISOTP_RX_BLOCK_SIZE))
+            {
+                NodeRx_BlockCount = 0u;
+                Node_SendFlowControl();
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    /* A single-frame FINISH, nothing longer is single */
+    if (((data[0] >> 4u) == 0u) && (data[1] == BOOT_SERVICE_FINISH))
+    {
+        Bench_VerifyLeft = Master_ImageSize;
+    }
+}
+
+static void Node_Event(const Bench_Frame *frame, bool txDone, bool isrOn)
+{
+    Bench_Event event;
+
+    event.Frame  = *frame;
+    event.TxDone = txDone;
+
+    if (isrOn == true)
+    {
+        Node_Isr(&event);
+        return;
+    }
+
+    if (Node_PendingCount == BENCH_QUEUE_SIZE)
+    {
+        fprintf(stderr, "node event queue overflow\n");
+        exit(1);
+    }
+    Node_Pending[Node_PendingCount++] = event;
+    if (Node_PendingCount > Node_PendingMax)
+    {
+        Node_PendingMax = Node_PendingCount;
+    }
+}
+
+static void Node_ServicePending(void)
+{
+    uint32_t i = 0u;
+
+    for (i = 0u; i < Node_PendingCount; i++)
+    {
+        Node_Isr(&Node_Pending[i]);
+    }
+    Node_PendingCount = 0u;
+}
+
+/*******************************************************************************
+ * Master
+ ******************************************************************************/
+
+static void Master_BuildRequest(uint32_t Index)
+{
+    uint32_t crc = 0u;
+    uint32_t offset = 0u;
+    uint32_t length = 0u;
+
+    if (Index == 0u)
+    {
+        crc = Bench_Crc32(Master_Image, Master_ImageSize);
+        Master_Msg[0] = BOOT_SERVICE_START;
+        Master_Msg[1] = (uint8_t)(Master_ImageSize >> 24u);
+        Master_Msg[2] = (uint8_t)(Master_ImageSize >> 16u);
+        Master_Msg[3] = (uint8_t)(Master_ImageSize >> 8u);
+        Master_Msg[4] = (uint8_t)Master_ImageSize;
+        Master_Msg[5] = (uint8_t)(crc >> 24u);
+        Master_Msg[6] = (uint8_t)(crc >> 16u);
+        Master_Msg[7] = (uint8_t)(crc >> 8u);
+        Master_Msg[8] = (uint8_t)crc;
+        Master_MsgLength = 9u;
+    }
+    else if (Index <= Master_BlockCount)
+    {
+        offset = (Index - 1u) * BOOT_BLOCK_SIZE;
+        length = Master_ImageSize - offset;
+        if (length > BOOT_BLOCK_SIZE)
+        {
+            length = BOOT_BLOCK_SIZE;
+        }
+        Master_Msg[0] = BOOT_SERVICE_DATA;
+        Master_Msg[1] = (uint8_t)((Index - 1u) >> 8u);
+        Master_Msg[2] = (uint8_t)(Index - 1u);
+        memcpy(&Master_Msg[3], &Master_Image[offset], length);
+        Master_MsgLength = length + 3u;
+    }
+    else
+    {
+        Master_Msg[0] = BOOT_SERVICE_FINISH;
+        Master_MsgLength = 1u;
+    }
+}
+
+static void Master_NextConsecutive(void)
+{
+    uint32_t count = Master_MsgLength - Master_MsgOffset;
+
+    if (count > 7u)
+    {
+        count = 7u;
+    }
+    memset(Master_Frame.Data, ISOTP_PADDING, sizeof(Master_Frame.Data));
+    Master_Frame.Data[0] = (uint8_t)(0x20u | (Master_Sn & 0x0Fu));
+    memcpy(&Master_Frame.Data[1], &Master_Msg[Master_MsgOffset], count);
+    Master_MsgOffset += count;
+    Master_Sn++;
+    Master_FrameReady = true;
+}
+
+/* START and FINISH wait for everything before them, blocks keep Window requests in flight */
+static void Master_Pump(void)
+{
+    uint32_t last = Master_BlockCount + 1u;
+
+    if ((Master_Sending == true) || (Master_Next > last))
+    {
+        return;
+    }
+    if (((Master_Next == 0u) || (Master_Next == last)) ? (Master_Acked != Master_Next)
+        : ((Master_Acked == 0u) || ((Master_Next - Master_Acked) >= Master_Window)))
+    {
+        return;
+    }
+
+    Master_BuildRequest(Master_Next);
+    Master_Sending = true;
+    memset(Master_Frame.Data, ISOTP_PADDING, sizeof(Master_Frame.Data));
+    Master_Frame.ToNode = true;
+
+    if (Master_MsgLength <= 7u)
+    {
+        Master_Frame.Data[0] = (uint8_t)Master_MsgLength;
+        memcpy(&Master_Frame.Data[1], Master_Msg, Master_MsgLength);
+        Master_MsgOffset = Master_MsgLength;
+    }
+    else
+    {
+        Master_Frame.Data[0] = (uint8_t)(0x10u | (Master_MsgLength >> 8u));
+        Master_Frame.Data[1] = (uint8_t)Master_MsgLength;
+        memcpy(&Master_Frame.Data[2], Master_Msg, 6u);
+        Master_MsgOffset = 6u;
+        Master_Sn = 1u;
+    }
+    Master_FrameReady = true;
+}
+
+/* A master frame left the bus */
+static void Master_OnTxDone(void)
+{
+    uint8_t pci = (uint8_t)(Master_Frame.Data[0] >> 4u);
+
+    if (Master_MsgOffset >= Master_MsgLength)
+    {
+        Master_Sending = false;
+        Master_Next++;
+        Master_Pump();
+    }
+    else if (pci == 1u)
+    {
+        Master_WaitFc = true;
+    }
+    else if ((Master_CfLeft != 0u) && (--Master_CfLeft == 0u))
+    {
+        Master_WaitFc = true;
+    }
+    else
+    {
+        Master_NextConsecutive();
+    }
+}
+
+static void Master_OnFrame(const Bench_Frame *frame)
+{
+    const uint8_t *data = frame->Data;
+
+    if (data[0] == 0x30u)
+    {
+        if (Master_WaitFc == true)
+        {
+            Master_WaitFc = false;
+            Master_CfLeft = data[1];
+            Master_NextConsecutive();
+        }
+        return;
+    }
+
+    /* Response: service + BOOT_SERVICE_RESPONSE, status */
+    if (data[2] != BOOT_OK)
+    {
+        fprintf(stderr, "service 0x%02X answered %u at request %u\n",
+                (unsigned)data[1], (unsigned)data[2], (unsigned)Master_Acked);
+        exit(1);
+    }
+
+    Master_Acked++;
+    if (Master_Acked == (Master_BlockCount + 2u))
+    {
+        Master_Done   = true;
+        Master_DoneUs = Sim_Now;
+    }
+    Master_Pump();
+}
+
+/*******************************************************************************
+ * Bus
+ ******************************************************************************/
+
+static void Bus_StartNext(void)
+{
+    if (Node_TxCount != 0u)
+    {
+        Bus_Frame  = Node_TxQueue[Node_TxHead];
+        Node_TxHead = (Node_TxHead + 1u) % BENCH_QUEUE_SIZE;
+        Node_TxCount--;
+    }
+    else if (Master_FrameReady == true)
+    {
+        Bus_Frame = Master_Frame;
+        Master_FrameReady = false;
+    }
+    else
+    {
+        return;
+    }
+
+    Bus_Busy = true;
+    Bus_End  = Sim_Now + Bus_FrameUs;
+}
+
+/* Advances the clock to t, completing the frames due by then */
+static void Bus_RunUntil(uint64_t t, bool isrOn)
+{
+    for (;;)
+    {
+        if (Bus_Busy == false)
+        {
+            Bus_StartNext();
+        }
+        if ((Bus_Busy == false) || (Bus_End > t))
+        {
+            break;
+        }
+
+        Sim_Now  = Bus_End;
+        Bus_Busy = false;
+        if (Bus_Frame.ToNode == true)
+        {
+            Node_Event(&Bus_Frame, false, isrOn);
+            Master_OnTxDone();
+        }
+        else
+        {
+            Node_Event(&Bus_Frame, true, isrOn);
+            Master_OnFrame(&Bus_Frame);
+        }
+    }
+
+    Sim_Now = t;
+}
+
+/*******************************************************************************
+ * Bench
+ ******************************************************************************/
+
+static void Bench_Run(const Bench_Scenario *scenario, const uint8_t *image)
+{
+    Boot_Status_Typedef status;
+    uint64_t before = 0u;
+    uint32_t chunk = 0u;
+    uint32_t iterations = 0u;
+
+    memset(Sim_Flash, 0xFF, sizeof(Sim_Flash));
+    Sim_Now = 0u;
+    Sim_FlashBusyUs = 0u;
+    Sim_Jumps = 0u;
+    Bus_FrameUs = (BENCH_FRAME_BITS * 1000000u) / scenario->Bitrate;
+    Bus_Busy = false;
+    Node_TxHead = 0u;
+    Node_TxCount = 0u;
+    Node_PendingCount = 0u;
+    Node_PendingMax = 0u;
+    Bench_VerifyLeft = 0u;
+
+    Master_Image      = image;
+    Master_ImageSize  = scenario->ImageSize;
+    Master_Window     = scenario->Window;
+    Master_BlockCount = (scenario->ImageSize + BOOT_BLOCK_SIZE - 1u) / BOOT_BLOCK_SIZE;
+    Master_Next       = 0u;
+    Master_Acked      = 0u;
+    Master_Sending    = false;
+    Master_FrameReady = false;
+    Master_WaitFc     = false;
+    Master_CfLeft     = 0u;
+    Master_Done       = false;
+
+    MID_Boot_Init();
+    Master_Pump();
+
+    while (Master_Done == false)
+    {
+        before = Sim_Now;
+        MID_Boot_Process();
+
+        /* Verify chunks cost CPU time, the ISR stays open */
+        chunk = 0u;
+        if (Bench_VerifyLeft != 0u)
+        {
+            chunk = (Bench_VerifyLeft > BOOT_VERIFY_CHUNK) ? BOOT_VERIFY_CHUNK : Bench_VerifyLeft;
+            Bench_VerifyLeft -= chunk;
+        }
+        if (Sim_Now == before)
+        {
+            Bus_RunUntil(Sim_Now + BENCH_LOOP_US + ((uint64_t)chunk * BENCH_CRC_NS_PER_BYTE) / 1000u, true);
+        }
+
+        if (++iterations > 100000000u)
+        {
+            fprintf(stderr, "no progress\n");
+            exit(1);
+        }
+    }
+
+    MID_Boot_GetStatus(&status);
+    if ((memcmp(&Sim_Flash[BOOT_SLOT_BASE], image, scenario->ImageSize) != 0) || (status.Verified == false))
+    {
+        fprintf(stderr, "slot does not hold the image\n");
+        exit(1);
+    }
+
+    MID_Boot_StartImage();
+    if ((Sim_Jumps != 1u) || (Sim_JumpTarget != BOOT_SLOT_BASE))
+    {
+        fprintf(stderr, "image not started after reset\n");
+        exit(1);
+    }
+
+    printf("%7u  %6u  %6u  %9.1f  %8.0f  %8.0f  %5.1f  %7u  %7u\n",
+           (unsigned)scenario->Bitrate, (unsigned)scenario->Window, (unsigned)scenario->ImageSize,
+           (double)Master_DoneUs / 1000.0,
+           (double)scenario->ImageSize * 1000000.0 / (double)Master_DoneUs,
+           (double)status.Programmed * 1000000.0 / (double)status.TransferUs,
+           100.0 * (double)Sim_FlashBusyUs / (double)Master_DoneUs,
+           (unsigned)Node_PendingMax, (unsigned)status.Dropped);
+}
+
+int main(void)
+{
+    static const Bench_Scenario scenarios[] =
+    {
+        {  500000u, 1u,  65536u },
+        {  500000u, 2u,  65536u },
+        {  500000u, 2u, 200003u },
+        { 1000000u, 1u,  65536u },
+        { 1000000u, 2u,  65536u },
+        { 1000000u, 2u, 200003u },
+    };
+    static uint8_t image[BOOT_IMAGE_MAX_SIZE];
+    uint32_t seed = 0x12345678u;
+    uint32_t i = 0u;
+
+    for (i = 0u; i < sizeof(image); i++)
+    {
+        seed = (seed * 1103515245u) + 12345u;
+        image[i] = (uint8_t)(seed >> 16u);
+    }
+
+    /* Initial SP in SRAM, reset vector inside the image */
+    image[0] = 0x00u; image[1] = 0x70u; image[2] = 0x00u; image[3] = 0x20u;
+    image[4] = 0x11u; image[5] = 0x04u; image[6] = 0x04u; image[7] = 0x00u;
+
+    printf("Boot update through MID_Boot_Process, erase %u us, phrase %u us, BS %u\n",
+           (unsigned)BENCH_ERASE_US, (unsigned)BENCH_PHRASE_US, (unsigned)ISOTP_RX_BLOCK_SIZE);
+    printf("bitrate  window   image   total ms  bytes/s  boot B/s  flash%%  fifo max  dropped\n");
+
+    for (i = 0u; i < (sizeof(scenarios) / sizeof(scenarios[0])); i++)
+    {
+        Bench_Run(&scenarios[i], image);
+    }
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * DRV_S32K144_FTFC.h
+ *
+ *  Host stub: simulated P-Flash for the host harnesses in tools/host, same API as
+ *  src/drivers/inc/DRV_S32K144_FTFC.h. Implemented by the harness.
+ */
+
+#ifndef DRV_S32K144_FTFC_H_
+#define DRV_S32K144_FTFC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FTFC_PFLASH_SIZE        (0x00080000u)
+#define FTFC_SECTOR_SIZE        (0x1000u)
+#define FTFC_PHRASE_SIZE        (8u)
+#define FTFC_SECTION_MAX_SIZE   (0x1000u)
+
+#define FTFC_FLASH_PTR(address) (Sim_FlashPtr(address))
+
+typedef enum
+{
+    FTFC_STATUS_SUCCESS,
+    FTFC_STATUS_INVALID_PARAM,
+    FTFC_STATUS_ACCESS_ERROR,
+    FTFC_STATUS_PROTECTION_ERROR,
+    FTFC_STATUS_VERIFY_ERROR
+} ftfc_status_t;
+
+const uint8_t *Sim_FlashPtr(uint32_t address);
+
+ftfc_status_t DRV_FTFC_EraseSector(uint32_t address);
+
+ftfc_status_t DRV_FTFC_ProgramPhrase(uint32_t address, const uint8_t *data);
+
+ftfc_status_t DRV_FTFC_ProgramSection(uint32_t address, const uint8_t *data, uint16_t length);
+
+#endif /* DRV_S32K144_FTFC_H_ */
@@ -0,0 +1,18 @@
+/*
+ * DRV_S32K144_NVIC.h
+ *
+ *  Host stub: critical sections and the image jump, implemented by the harness.
+ */
+
+#ifndef DRV_S32K144_NVIC_H_
+#define DRV_S32K144_NVIC_H_
+
+#include <stdint.h>
+
+uint32_t NVIC_EnterCritical(void);
+
+void NVIC_ExitCritical(uint32_t primask);
+
+void NVIC_JumpToImage(uint32_t vectorTable);
+
+#endif /* DRV_S32K144_NVIC_H_ */
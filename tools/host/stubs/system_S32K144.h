@@ -0,0 +1,12 @@
+/*
+ * system_S32K144.h
+ *
+ *  Host stub: system reset, implemented by the harness.
+ */
+
+#ifndef SYSTEM_S32K144_H_
+#define SYSTEM_S32K144_H_
+
+void SystemSoftwareReset(void);
+
+#endif /* SYSTEM_S32K144_H_ */
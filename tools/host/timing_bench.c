@@ -0,0 +1,120 @@
+/*
+ *  Filename: timing_bench.c
+ *
+ *  Host benchmark: the bit-timing step of DRV_FLEXCAN_Init, table lookup against the
+ *  runtime search it falls back to. The driver source is included so its static
+ *  functions run unchanged. Every table entry must equal what the search computes.
+ *  The rest of DRV_FLEXCAN_Init is the same on both paths and is not timed.
+ *
+ *  Usage: make -C tools/host run
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "DRV_S32K144_FLEXCAN.c"
+
+#define BENCH_LOOKUP_CALLS  (200000u)
+#define BENCH_SEARCH_CALLS  (20000u)
+
+/* Combinations outside the table, served by the search only */
+static const uint32_t Bench_Fallback[][3] =
+{
+    {  8000000u,  125000u, 80u },
+    { 48000000u,  500000u, 80u },
+    { 80000000u,   83333u, 80u },
+};
+
+static volatile uint32_t Bench_Sink = 0u;
+
+static double Bench_NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+static double Bench_LookupNs(uint32_t clkFreq, uint32_t bitrate, uint32_t samplePoint)
+{
+    flexcan_time_segment_t timeSeg = { 0 };
+    double start = Bench_NowNs();
+    uint32_t i = 0u;
+
+    for (i = 0u; i < BENCH_LOOKUP_CALLS; i++)
+    {
+        Bench_Sink += FLEXCAN_LookupTimeSeg(bitrate, clkFreq, samplePoint, &timeSeg);
+        Bench_Sink += timeSeg.presDiv;
+    }
+
+    return (Bench_NowNs() - start) / BENCH_LOOKUP_CALLS;
+}
+
+static double Bench_SearchNs(uint32_t clkFreq, uint32_t bitrate, uint32_t samplePoint)
+{
+    flexcan_time_segment_t timeSeg;
+    double start = Bench_NowNs();
+    uint32_t i = 0u;
+
+    for (i = 0u; i < BENCH_SEARCH_CALLS; i++)
+    {
+        FLEXCAN_BitrateToTimeSeg(bitrate, clkFreq, samplePoint, &timeSeg);
+        Bench_Sink += timeSeg.presDiv;
+    }
+
+    return (Bench_NowNs() - start) / BENCH_SEARCH_CALLS;
+}
+
+int main(void)
+{
+    const uint32_t count = (uint32_t)(sizeof(g_flexcanTimingTable) / sizeof(g_flexcanTimingTable[0]));
+    const flexcan_timing_entry_t *entry = NULL;
+    flexcan_time_segment_t searched;
+    double lookupNs = 0.0;
+    double searchNs = 0.0;
+    double lookupSum = 0.0;
+    double searchSum = 0.0;
+    uint32_t mismatches = 0u;
+    uint32_t i = 0u;
+
+    printf("FlexCAN bit timing in DRV_FLEXCAN_Init, ns per call on the host\n");
+    printf("   clock  bitrate  sp   table  search  speedup\n");
+
+    for (i = 0u; i < count; i++)
+    {
+        entry = &g_flexcanTimingTable[i];
+
+        FLEXCAN_BitrateToTimeSeg(entry->bitrate, entry->clkFreq, entry->samplePoint, &searched);
+        if (memcmp(&searched, &entry->timeSeg, sizeof(searched)) != 0)
+        {
+            mismatches++;
+            printf("MISMATCH %u Hz %u bit/s %u %%\n", (unsigned)entry->clkFreq,
+                   (unsigned)entry->bitrate, (unsigned)entry->samplePoint);
+        }
+
+        lookupNs = Bench_LookupNs(entry->clkFreq, entry->bitrate, entry->samplePoint);
+        searchNs = Bench_SearchNs(entry->clkFreq, entry->bitrate, entry->samplePoint);
+        lookupSum += lookupNs;
+        searchSum += searchNs;
+
+        printf("%8u %8u %3u  %6.1f  %6.1f  %6.1fx\n", (unsigned)entry->clkFreq, (unsigned)entry->bitrate,
+               (unsigned)entry->samplePoint, lookupNs, searchNs, searchNs / lookupNs);
+    }
+
+    printf("mean over %u entries: table %.1f ns, search %.1f ns, %.1fx\n",
+           (unsigned)count, lookupSum / count, searchSum / count, searchSum / lookupSum);
+
+    /* A miss scans the whole table before the search */
+    for (i = 0u; i < (sizeof(Bench_Fallback) / sizeof(Bench_Fallback[0])); i++)
+    {
+        lookupNs = Bench_LookupNs(Bench_Fallback[i][0], Bench_Fallback[i][1], Bench_Fallback[i][2]);
+        searchNs = Bench_SearchNs(Bench_Fallback[i][0], Bench_Fallback[i][1], Bench_Fallback[i][2]);
+        printf("fallback %8u %8u %3u: miss %.1f ns + search %.1f ns\n", (unsigned)Bench_Fallback[i][0],
+               (unsigned)Bench_Fallback[i][1], (unsigned)Bench_Fallback[i][2], lookupNs, searchNs);
+    }
+
+    printf("table entries differing from the search: %u\n", (unsigned)mismatches);
+
+    return (mismatches == 0u) ? 0 : 1;
+}
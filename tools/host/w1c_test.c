@@ -0,0 +1,188 @@
+/*
+ *  Filename: w1c_test.c
+ *
+ *  Host test: the write-1-to-clear flag paths of the FlexCAN and LPIT drivers against
+ *  a register model. The drivers run unchanged on RAM copies of the register blocks.
+ *  A clear path stores once: the value it leaves in the register is the value written,
+ *  and W1C hardware keeps pending & ~written. With several flags raised at once, only
+ *  the flags the caller asked for may go.
+ *
+ *  Usage: make -C tools/host run
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "DRV_S32K144_FLEXCAN.h"
+#include "DRV_S32K144_LPIT.h"
+
+extern LPIT_Type *g_LpitBase[LPIT_INSTANCE_COUNT];
+extern flexcan_handle_t *g_flexcanHandle[FLEXCAN_INSTANCE_COUNT];
+
+void CAN0_ORed_IRQHandler(void);
+
+static FLEXCAN_Type Test_Can;
+static LPIT_Type    Test_Lpit;
+static uint32_t     Test_Failures = 0u;
+static uint32_t     Test_Cases = 0u;
+
+/* Flag patterns raised together, each one a burst of events under load */
+static const uint32_t Test_Pending[] =
+{
+    0x00000001u, 0x00000003u, 0x000000E0u, 0x0000FFFFu, 0xFFFF0000u,
+    0xA5A5A5A5u, 0x80000001u, 0xFFFFFFFFu
+};
+
+#define TEST_PENDING_COUNT  (sizeof(Test_Pending) / sizeof(Test_Pending[0]))
+
+/* W1C hardware: every 1 written clears its flag, 0 leaves it */
+static uint32_t Test_W1C(uint32_t pending, uint32_t written)
+{
+    return pending & ~written;
+}
+
+static bool Test_Clears(uint32_t pending, uint32_t cleared, uint32_t written)
+{
+    return (Test_W1C(pending, written) == (pending & ~cleared));
+}
+
+static void Test_Check(const char *name, uint32_t pending, uint32_t cleared, uint32_t written)
+{
+    Test_Cases++;
+    if (Test_Clears(pending, cleared, written) == false)
+    {
+        Test_Failures++;
+        printf("FAIL %s: pending 0x%08X clear 0x%08X wrote 0x%08X, left 0x%08X instead of 0x%08X\n",
+               name, (unsigned)pending, (unsigned)cleared, (unsigned)written,
+               (unsigned)Test_W1C(pending, written), (unsigned)(pending & ~cleared));
+    }
+}
+
+/* The model must catch the read-modify-write form: IFLAG1 |= bit writes back every pending flag */
+static void Test_ModelDetectsReadModifyWrite(void)
+{
+    Test_Can.IFLAG1 = 0x00000006u;
+    Test_Can.IFLAG1 |= 0x00000002u;
+
+    Test_Cases++;
+    if (Test_Clears(0x00000006u, 0x00000002u, Test_Can.IFLAG1) == true)
+    {
+        Test_Failures++;
+        printf("FAIL model does not catch IFLAG1 |= bit\n");
+    }
+}
+
+static void Test_FlexcanClearMbIntFlag(void)
+{
+    uint32_t p = 0u;
+    uint8_t  mbIdx = 0u;
+
+    for (p = 0u; p < TEST_PENDING_COUNT; p++)
+    {
+        for (mbIdx = 0u; mbIdx < 32u; mbIdx++)
+        {
+            Test_Can.IFLAG1 = Test_Pending[p];
+            DRV_FLEXCAN_ClearMbIntFlag(0u, mbIdx);
+            Test_Check("DRV_FLEXCAN_ClearMbIntFlag", Test_Pending[p], (1UL << mbIdx), Test_Can.IFLAG1);
+        }
+    }
+}
+
+static void Test_FlexcanClearMbIntFlags(void)
+{
+    static const uint32_t masks[] = { 0x00000001u, 0x00000006u, 0x0000FF00u, 0x80000000u, 0x5A5A5A5Au };
+    uint32_t p = 0u;
+    uint32_t m = 0u;
+
+    for (p = 0u; p < TEST_PENDING_COUNT; p++)
+    {
+        for (m = 0u; m < (sizeof(masks) / sizeof(masks[0])); m++)
+        {
+            Test_Can.IFLAG1 = Test_Pending[p];
+            DRV_FLEXCAN_ClearMbIntFlags(0u, masks[m]);
+            Test_Check("DRV_FLEXCAN_ClearMbIntFlags", Test_Pending[p], masks[m], Test_Can.IFLAG1);
+        }
+    }
+}
+
+/* The snapshot read must not clear anything */
+static void Test_FlexcanGetMbIntFlags(void)
+{
+    uint32_t p = 0u;
+    uint32_t flags = 0u;
+
+    for (p = 0u; p < TEST_PENDING_COUNT; p++)
+    {
+        Test_Can.IFLAG1 = Test_Pending[p];
+        Test_Can.IMASK1 = 0x0F0F0F0Fu;
+        flags = DRV_FLEXCAN_GetMbIntFlags(0u);
+
+        Test_Cases++;
+        if ((flags != (Test_Pending[p] & 0x0F0F0F0Fu)) || (Test_Can.IFLAG1 != Test_Pending[p]))
+        {
+            Test_Failures++;
+            printf("FAIL DRV_FLEXCAN_GetMbIntFlags: returned 0x%08X, IFLAG1 0x%08X\n",
+                   (unsigned)flags, (unsigned)Test_Can.IFLAG1);
+        }
+    }
+}
+
+/* The error ISR clears exactly the events it reports */
+static void Test_FlexcanErrorIsr(void)
+{
+    static flexcan_handle_t handle;
+    uint32_t p = 0u;
+    uint32_t pending = 0u;
+
+    memset(&handle, 0, sizeof(handle));
+    g_flexcanHandle[0] = &handle;
+
+    for (p = 0u; p < TEST_PENDING_COUNT; p++)
+    {
+        pending = Test_Pending[p] & FLEXCAN_ERROR_EVENT_MASK;
+        Test_Can.ESR1 = pending;
+        CAN0_ORed_IRQHandler();
+        Test_Check("CAN0_ORed_IRQHandler ESR1", pending, pending, Test_Can.ESR1);
+
+        Test_Cases++;
+        if ((Test_Can.ESR1 & ~FLEXCAN_ERROR_EVENT_MASK) != 0u)
+        {
+            Test_Failures++;
+            printf("FAIL CAN0_ORed_IRQHandler wrote 0x%08X outside the events\n", (unsigned)Test_Can.ESR1);
+        }
+    }
+}
+
+static void Test_LpitClearInterruptFlag(void)
+{
+    uint32_t pending = 0u;
+    uint8_t  ch = 0u;
+
+    /* Every combination of the four TIF flags */
+    for (pending = 0u; pending < 16u; pending++)
+    {
+        for (ch = 0u; ch < 4u; ch++)
+        {
+            Test_Lpit.MSR = pending;
+            DRV_LPIT_ClearInterruptFlagTimerChannels(0u, (LPIT_ChannelTypedef)ch);
+            Test_Check("DRV_LPIT_ClearInterruptFlagTimerChannels", pending, (LPIT_MSR_TIF0_MASK << ch), Test_Lpit.MSR);
+        }
+    }
+}
+
+int main(void)
+{
+    g_flexcanBase[0] = &Test_Can;
+    g_LpitBase[0]    = &Test_Lpit;
+
+    Test_ModelDetectsReadModifyWrite();
+    Test_FlexcanClearMbIntFlag();
+    Test_FlexcanClearMbIntFlags();
+    Test_FlexcanGetMbIntFlags();
+    Test_FlexcanErrorIsr();
+    Test_LpitClearInterruptFlag();
+
+    printf("W1C flag paths: %u cases, %u failures\n", (unsigned)Test_Cases, (unsigned)Test_Failures);
+
+    return (Test_Failures == 0u) ? 0 : 1;
+}